@@ -0,0 +1,45 @@
+#ifndef ANSWERSTORE_H
+#define ANSWERSTORE_H
+
+#include <QObject>
+#include <QHash>
+#include <QJsonObject>
+#include <QStringList>
+
+// 问卷答案存储
+// 每道题的答案由输入控件的变化信号增量写入，提交、规则计算、
+// 必答检查和答案恢复都直接读取这里，不再遍历页面控件
+class SurveyAnswerStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SurveyAnswerStore(QObject *parent = nullptr);
+
+    // 写入某道题的答案，空对象表示清除该题答案；返回答案是否发生变化
+    bool setAnswer(const QString& questionId, const QJsonObject& answer);
+    void removeAnswer(const QString& questionId);
+    void clear();
+
+    QJsonObject answer(const QString& questionId) const;
+    bool hasAnswer(const QString& questionId) const;
+    QStringList answeredQuestions() const;
+    int count() const { return m_answers.size(); }
+
+    // 全部答案，格式与提交接口一致: {"questionId": {...}}
+    // 快照随写入同步维护，读取时不需要重新组装
+    QJsonObject toJson() const { return m_snapshot; }
+
+    // 修订号，每次答案变化加一
+    quint64 revision() const { return m_revision; }
+
+signals:
+    void answerChanged(const QString& questionId);
+
+private:
+    QHash<QString, QJsonObject> m_answers;
+    QJsonObject m_snapshot;
+    quint64 m_revision = 0;
+};
+
+#endif // ANSWERSTORE_H
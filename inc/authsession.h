@@ -0,0 +1,46 @@
+#ifndef AUTHSESSION_H
+#define AUTHSESSION_H
+
+#include <QString>
+#include <QJsonObject>
+#include <QJsonArray>
+
+// 登录会话持久化
+// 保存令牌、过期时间、当前用户和上次的项目列表。启动时会话没有过期就直接使用令牌，
+// 先显示缓存的项目列表，同时在后台刷新，不再每次都经过登录页。
+// 只在NetworkManager线程中使用。
+class AuthSession
+{
+public:
+    explicit AuthSession(const QString& filePath);
+
+    // 读取保存的会话，令牌已过期时清除并返回false
+    bool load();
+    bool isValid() const;
+
+    QString token() const { return m_token; }
+    qint64 expiresAt() const { return m_expiresAt; }
+    QJsonObject user() const { return m_user; }
+    QJsonArray projects() const { return m_projects; }
+
+    // 登录成功后保存令牌，过期时间优先取JWT中的exp，取不到时按defaultTtlSecs计算
+    void start(const QString& token, qint64 defaultTtlSecs);
+    void setUser(const QJsonObject& user);
+    void setProjects(const QJsonArray& projects);
+    // 退出登录或令牌失效
+    void clear();
+
+    // JWT载荷中的exp（秒），不是JWT或没有exp时返回0
+    static qint64 tokenExpiry(const QString& token);
+
+private:
+    bool save() const;
+
+    QString m_filePath;
+    QString m_token;
+    qint64 m_expiresAt = 0;     // 毫秒时间戳
+    QJsonObject m_user;         // /currentUser的响应
+    QJsonArray m_projects;      // /project/list中的list
+};
+
+#endif // AUTHSESSION_H
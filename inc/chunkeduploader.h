@@ -0,0 +1,94 @@
+#ifndef CHUNKEDUPLOADER_H
+#define CHUNKEDUPLOADER_H
+
+#include <QObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QJsonObject>
+#include <QHash>
+#include <QSet>
+#include <QVariant>
+#include <QPointer>
+
+// 分片断点续传
+// 文件按固定大小切分，每个分片带MD5校验单独发送，已确认的分片记录在本地进度文件中。
+// 上传中断后再次上传同一个文件（路径、大小和修改时间不变）时只发送缺失的分片。
+//
+// 接口约定:
+//   POST /public/upload/chunk/init      {projectId, questionId, fileName, size, chunkSize, chunkCount, md5, uploadId}
+//        -> {"data": {"uploadId": "...", "received": [已收到的分片下标]}}
+//   POST /public/upload/chunk?uploadId=...&index=n   分片内容，Content-MD5为分片校验
+//   POST /public/upload/chunk/complete  {uploadId} -> 与 /public/upload 相同的响应
+// 初始化请求被服务器拒绝（任何错误状态码或错误响应）时通过failed(unsupported=true)通知调用方改用整文件上传。
+class ChunkedUploader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ChunkedUploader(QNetworkAccessManager *networkManager, const QString& progressFile,
+                             QObject *parent = nullptr);
+
+    void setBaseUrl(const QString& baseUrl) { m_baseUrl = baseUrl; }
+    void setAuthToken(const QString& token) { m_authToken = token; }
+    void setChunkSize(qint64 chunkSize) { m_chunkSize = qMax<qint64>(64 * 1024, chunkSize); }
+    qint64 chunkSize() const { return m_chunkSize; }
+
+    // 开始或继续上传，context原样带回结果信号。文件无法读取时返回false
+    bool upload(const QString& projectId, const QString& questionId, const QString& filePath,
+                const QVariant& context = QVariant());
+
+    // 中止文件的上传，通过failed通知调用方，已确认的分片仍会保留
+    bool cancel(const QString& filePath);
+
+signals:
+    void progress(const QVariant& context, qint64 bytesSent, qint64 bytesTotal);
+    // response与 /public/upload 的响应相同
+    void finished(const QVariant& context, const QJsonObject& response);
+    void failed(const QVariant& context, const QString& error, bool unsupported);
+
+private:
+    enum Stage {
+        Init,
+        Part,
+        Complete
+    };
+
+    struct Session {
+        QString key;            // 文件路径、大小和修改时间的摘要
+        QString projectId;
+        QString questionId;
+        QString filePath;
+        QString fileName;
+        QString md5;
+        qint64 size = 0;
+        qint64 chunkSize = 0;
+        int chunkCount = 0;
+        QString uploadId;
+        QSet<int> received;     // 服务器已确认的分片
+        QVariant context;
+        QPointer<QNetworkReply> reply;  // 正在发送的请求
+    };
+
+    void sendInit(Session& session);
+    void sendNextPart(Session& session);
+    void sendComplete(Session& session);
+    QNetworkRequest createRequest(const QString& endpoint, Stage stage, const QString& key) const;
+    void onReplyFinished(QNetworkReply *reply);
+    void fail(const QString& key, const QString& error, bool unsupported);
+    qint64 confirmedBytes(const Session& session) const;
+    // 只接受[0, chunkCount)范围内的分片下标
+    static void setReceived(Session& session, const QJsonArray& received);
+
+    void loadProgress();
+    void saveProgress();
+
+    QNetworkAccessManager *m_networkManager;
+    QString m_progressFile;
+    QString m_baseUrl;
+    QString m_authToken;
+    qint64 m_chunkSize = 512 * 1024;
+    QHash<QString, Session> m_sessions;     // 正在上传的文件
+    QJsonObject m_progress;                 // 持久化的上传进度: key -> {uploadId, chunkSize, received}
+};
+
+#endif // CHUNKEDUPLOADER_H
@@ -0,0 +1,81 @@
+#ifndef GLOBALRULE_H
+#define GLOBALRULE_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVector>
+#include "ruleexpression.h"
+
+class SurveyAnswerStore;
+class SurveyModel;
+
+// 全局规则中的一个条件项，如 {"qId": "q1", "condition": "CHECKED", "oId": ["o1", "o2"]}
+struct GlobalRuleCondition
+{
+    enum Type {
+        Checked,    // 选中了oId中的任一选项
+        Unknown     // 暂不支持的条件，按不满足处理
+    };
+
+    // 答案按题目id和选项id保存，条件直接按id匹配；隐藏题目的答案同样可以作为条件
+    Type type = Unknown;
+    QString questionId;
+    QStringList optionIds;
+};
+
+// 条件满足后执行的动作，如 {"type": "jump", "qId": "q5"}
+struct GlobalRuleAction
+{
+    enum Type {
+        Jump,
+        Unknown
+    };
+
+    Type type = Unknown;
+    QString questionId;
+    int questionIndex = -1;     // 跳转目标在可见题目中的下标
+};
+
+// 问卷加载时编译好的全局规则（survey.attribute.globalRule中的一项）
+// 结构化规则解析为条件表和动作表，其余字符串按逻辑表达式编译
+class GlobalRule
+{
+public:
+    enum Kind {
+        Structured,     // {"conditionItem": [...], "conditionLogic": "AND", "result": [...]}
+        Expression,     // 逻辑表达式，结果为false时阻止翻页
+        Invalid         // 无法识别的规则，忽略
+    };
+
+    enum Logic {
+        And,
+        Or
+    };
+
+    // 根据问卷模型把跳转目标解析为可见题目的下标
+    static GlobalRule compile(const QString& rule, const SurveyModel& model);
+
+    Kind kind() const { return m_kind; }
+    Logic logic() const { return m_logic; }
+    QString source() const { return m_source; }
+    const QVector<GlobalRuleCondition>& conditions() const { return m_conditions; }
+    const QVector<GlobalRuleAction>& actions() const { return m_actions; }
+    const RuleExpression& expression() const { return m_expression; }
+
+    // 规则读取到的题目id
+    QStringList referencedQuestions() const;
+
+    // 结构化规则的条件是否满足
+    bool conditionsMet(const SurveyAnswerStore& answers) const;
+
+private:
+    Kind m_kind = Invalid;
+    Logic m_logic = And;
+    QString m_source;
+    QVector<GlobalRuleCondition> m_conditions;
+    QVector<GlobalRuleAction> m_actions;
+    RuleExpression m_expression;
+};
+
+#endif // GLOBALRULE_H
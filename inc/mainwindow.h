@@ -12,6 +12,7 @@
 #include <QNetworkAccessManager>
 #include "functionlogger.h"
 #include "settingswidget.h"
+#include "surveymodel.h"
 
 
 class DashboardWidget;
@@ -29,10 +30,12 @@ signals:
     void SignalregisterUser(const QString& username, const QString& password);
     void SignalgetSurveyList();
     void SignalgetSurveySchema(const QString& surveyId);
-    void SignalsubmitResponse(const QString& surveyId, const QJsonObject& data, qint64 diifTime);
+    void SignalsubmitResponse(const QString& surveyId, const QJsonObject& data, const QJsonArray& attachments, qint64 diifTime);
     void SignalSetAuth(const QString& token);
     void SignalgetProjectList();
     void SignalgetCurrentUser();
+    void SignalcancelUploads(const QString& projectId);
+    void SignalsetKeepAlive(bool enabled);
 
 public:
     MainWindow(QWidget *parent = nullptr);
@@ -53,13 +56,18 @@ private slots:
     void onRegisterRequested(const QString& username, const QString& password);
     void onLoginRequested(const QString& username, const QString& password);
     void onProjectListReceived(const QJsonArray& projects);
-    void onSurveySchemaReceived(const QJsonObject& schema);
+    void onSessionRestored(const QJsonObject& userInfo, const QJsonArray& projects);
+    void onSessionExpired();
+    void onSurveySchemaReceived(const SurveyModelPtr& model);
+    void onSubmitQueued();
     void onSubmitSuccess();
+    void onPendingSubmissionsChanged(int count);
+    void onUploadQueueChanged(int queued, int running);
     void onSubmitFailed(const QString& error);
     void onNetworkError(const QString& error);
     void showLoginDialog();
-    void showDashboard();
-    void onSubmitResponse(const QJsonObject& data);
+    void showDashboard(bool loadProjects = true);
+    void onSubmitResponse(const QJsonObject& data, const QJsonArray& attachments);
     void onBackToSurveyList();
 
 private:
@@ -73,6 +81,9 @@ private:
     void createMenus();
     void InitLog();
     void requestInitialPermissions();
+    void updateStatusLabel();
+    // 离开问卷页面，登录已失效时回到登录页
+    void returnToDashboard();
 
     QStackedWidget *m_stackedWidget;
     DashboardWidget *m_dashboardWidget;
@@ -90,9 +101,12 @@ private:
     QAction *m_aboutAction;
     
     QLabel *m_statusLabel;
+    int m_pendingSubmissions = 0;
+    int m_queuedUploads = 0;
     
     // Data
     QJsonObject m_currentUser;
+    bool m_sessionExpired = false;      // 填写问卷时登录失效，离开问卷后再回到登录页
     QString m_currentSurveyId;
     QString m_currentSurveyTitle;
 };
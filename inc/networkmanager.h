@@ -14,9 +14,23 @@
 #include <QHttpMultiPart>
 #include <QNetworkInterface>
 #include <QNetworkAddressEntry>
+#include <QSet>
+#include <QTimer>
 #include "surveyencrypt.h"
 #include "locationmanager.h"
 #include "functionlogger.h"
+#include "surveymodel.h"
+#include "submissionjournal.h"
+#include "chunkeduploader.h"
+#include "uploadscheduler.h"
+#include "schemacache.h"
+#include "requestbody.h"
+#include "retrypolicy.h"
+#include "authsession.h"
+#include "serverselector.h"
+#include <QPointer>
+#include <QScopedPointer>
+#include <functional>
 
 class NetworkManager : public QObject
 {
@@ -34,15 +48,24 @@ signals:
     void loginFailed(const QString& error);
     void registerSuccess(const QJsonObject& userInfo);
     void registerFailed(const QString& error);
-    void surveySchemaReceived(const QJsonObject& schema);
-    void submitSuccess();
+    void surveySchemaReceived(const SurveyModelPtr& model); // 已在网络线程中编译好的问卷模型
+    void submitQueued(const QString& submissionId);     // 问卷已写入本地提交日志
+    void submitSuccess();                               // 提交日志中的一份问卷已被服务器确认
     void submitFailed(const QString& error);
+    void pendingSubmissionsChanged(int count);
     void networkError(const QString& error);
+    void networkWarning(const QString& message);        // 不需要打断用户的网络提示
+    void retryMetricsChanged(const QJsonObject& metrics);   // 各接口的重试和熔断统计
     void captchaReceived(const QString& captchaId, const QPixmap& captchaImage);
     void currentUserReceived(const QJsonObject& userInfo);
     void projectListReceived(const QJsonArray& projects);
-    void fileUploadSuccess(const QJsonObject& response);
-    void fileUploadFailed(const QString& error);
+    // 启动时恢复了上次的登录会话，带缓存的用户信息和项目列表，最新数据随后通过上面两个信号到达
+    void sessionRestored(const QJsonObject& userInfo, const QJsonArray& projects);
+    void sessionExpired();                              // 令牌被服务器拒绝，需要重新登录
+    void fileUploadSuccess(quint64 requestId, const QJsonObject& response);
+    void fileUploadFailed(quint64 requestId, const QString& error);
+    void fileUploadProgress(quint64 requestId, qint64 bytesSent, qint64 bytesTotal);
+    void uploadQueueChanged(int queued, int running);   // 上传队列深度
 
 public slots:
     void InitManager();
@@ -56,38 +79,165 @@ public slots:
     // 问卷相关
     void getSurveyList(int pageSize = 10, int curPage = 1);
     void getSurveySchema(const QString& surveyId);
-    void submitResponse(const QString& surveyId, const QJsonObject& data, qint64 diffTime);
-    void uploadFile(const QString& projectId, const QString& questionId, const QString& filePath);
+    void submitResponse(const QString& surveyId, const QJsonObject& data, const QJsonArray& attachments, qint64 diffTime);
+    void uploadFile(quint64 requestId, const QString& projectId, const QString& questionId, const QString& filePath,
+                    UploadPriority priority = UploadPriority::UserFile);
+    void cancelUpload(quint64 requestId);
+    // 取消问卷还没有上传完成的文件（已提交问卷的附件除外）
+    void cancelUploads(const QString& projectId);
     
     // 仪表板相关
     void getCurrentUser();
     void getProjectList();
 
+    // 记录并发出当前的重试和连接复用统计
+    void reportRetryMetrics();
+
+    // 提前与服务器建立连接，第一个请求不再等待DNS解析和握手
+    void warmUpConnection();
+    // 填写问卷期间定时预连接，服务器关闭空闲连接后及时补上
+    void setKeepAlive(bool enabled);
+
 private slots:
     void onReplyFinished(QNetworkReply* reply);
+    // 按并发上限发送提交日志中的问卷
+    void startSubmissionSync();
+    void onUploadTaskStarted(quint64 taskId, const QVariantMap& task);
+    void onKeepAliveTimeout();
+    // 切换到探测选出的服务器
+    void onServerChanged(const QString& baseUrl);
 
 
 private:
     explicit NetworkManager(QObject* parent = nullptr);
     QNetworkRequest createRequest(const QString& url);
+    // 登记响应的处理函数，onReplyFinished按响应对象分发
+    using ReplyHandler = std::function<void(QNetworkReply*)>;
+    void expectReply(QNetworkReply* reply, const ReplyHandler& handler);
+    // 网络错误统一发出networkError，成功时把JSON交给handler
+    void expectJson(QNetworkReply* reply, void (NetworkManager::*handler)(QNetworkReply*, QJsonObject));
+    // 按接口的重试策略发送，失败时重新调用send；熔断期间不发送，handler收到nullptr
+    using RequestSender = std::function<QNetworkReply*()>;
+    void sendWithRetry(const QString& endpoint, const RequestSender& send, const ReplyHandler& handler, int attempt = 0);
+    // 合并相同的未完成请求，key相同的调用共用一个响应：
+    // handler由第一次调用登记，每个响应只执行一次；completion按调用依次执行，处理各调用方自己的结果
+    void sendShared(const QString& key, const QString& endpoint, const RequestSender& send, const ReplyHandler& handler,
+                    const ReplyHandler& completion = ReplyHandler());
+    static QByteArray replyBody(QNetworkReply* reply);
+    void requestJson(const QString& key, const QString& endpoint, const RequestSender& send,
+                     void (NetworkManager::*handler)(QNetworkReply*, QJsonObject));
+    void reportNetworkFailure(const QString& endpoint, const QString& error);
+    // 服务器返回401时清除会话并通知界面回到登录页
+    void expireSession();
     QString getLocalIPv4Address();
+    // 按响应是否新建了连接统计复用率，并记录服务器是否可用
+    void recordConnectionUse(QNetworkReply* reply);
     void handleCurrentUser(QNetworkReply* reply, QJsonObject jsonObj);
     void handleSystemInfo(QNetworkReply* reply, QJsonObject jsonObj);
     void handleLoginResponse(QNetworkReply* reply, QJsonObject jsonObj);
     void handleRegisterResponse(QNetworkReply* reply,QJsonObject jsonObj);
-    void handleSurveyListResponse(QJsonObject jsonObj);
-    void handleSurveySchemaResponse(QJsonObject jsonObj);
-    void handleSubmitResponse(QNetworkReply* reply,QJsonObject jsonObj);
-    void handleProjectListResponse(QJsonObject jsonObj);
-    void handleFileUploadFinished(QNetworkReply* reply, QJsonObject jsonObj);
+    // 问卷结构响应写入缓存，打开问卷和预取共用，每个响应只执行一次
+    // version为请求发出时项目列表中的updateAt
+    void storeSchemaReply(QNetworkReply* reply, const QString& surveyId, const QString& version);
+    // renderedFromCache表示已经用缓存显示过问卷
+    void handleSurveySchemaReply(QNetworkReply* reply, const QString& surveyId, bool renderedFromCache);
+    QNetworkReply* postSchemaRequest(const QString& surveyId);
+    // 后台预取项目列表中已发布的问卷结构
+    void prefetchSchemas(const QJsonArray& projects);
+    void startSchemaPrefetch();
+    void handleSchemaPrefetchReply(QNetworkReply* reply, const QString& surveyId);
+    // attachmentIndex为-1时是答案请求
+    void handleSubmissionReply(QNetworkReply* reply, const QString& submissionId, int attachmentIndex);
+    void sendSubmission(const QString& submissionId);
+    void finishSubmission(const QString& submissionId, bool retryLater);
+    void finishAttachmentUpload(const QString& submissionId, int index, bool success, const QJsonObject& jsonObj);
+    void continueSubmission(const QString& submissionId);
+    bool isAttachmentAdopted(const QString& submissionId, int index) const;
+    void adoptFormUploads(const QString& submissionId, const QJsonArray& attachments);
+    void sendMultiPartUpload(quint64 taskId, const QVariantMap& task);
+    void releaseUploadTask(quint64 taskId);
+    void finishFileUpload(quint64 taskId, quint64 requestId, bool transportOk, const QJsonObject& jsonObj,
+                          const QString& error);
+    // 超过一个分片的文件走分片上传，返回false时调用方改用整文件上传
+    bool startChunkedUpload(const QString& projectId, const QString& questionId, const QString& filePath,
+                            const QVariantMap& context);
+    void onChunkedUploadFinished(const QVariant& context, const QJsonObject& response);
+    void onChunkedUploadFailed(const QVariant& context, const QString& error, bool unsupported);
+    void onChunkedUploadProgress(const QVariant& context, qint64 bytesSent, qint64 bytesTotal);
+    void cancelUploadTask(quint64 taskId);
+    // 可重试的上传失败在退避后重新开始，返回false时由调用方结束任务
+    bool retryUploadLater(quint64 taskId, const QVariantMap& task, bool retryable);
+    bool isOffline() const;
+    QHttpMultiPart* createUploadMultiPart(const QString& projectId, const QString& questionId, const QString& filePath);
+    void handleProjectListResponse(QNetworkReply* reply, QJsonObject jsonObj);
+    void handleFileUploadFinished(quint64 requestId, const QJsonObject& jsonObj);
 
     QNetworkAccessManager* m_networkManager;
+    QHash<QNetworkReply*, ReplyHandler> m_replyHandlers;    // 未完成的请求 -> 处理函数
+    RetryController m_retry;
+    struct SharedRequest
+    {
+        ReplyHandler handler;               // 每个响应只执行一次
+        QList<ReplyHandler> completions;    // 每次调用各一个
+    };
+    QHash<QString, SharedRequest> m_sharedRequests;  // 未完成的可合并请求
+    quint64 m_coalescedRequests = 0;
+
+    // 连接预热与保活
+    QTimer* m_keepAliveTimer;
+    qint64 m_lastWarmUpAt = 0;
+    qint64 m_lastResponseAt = 0;            // 最近一次收到响应，期间连接一定可用
+    bool m_appActive = true;                // 应用在前台，由applicationStateChanged更新
+    quint64 m_warmUps = 0;
+    quint64 m_connectionsOpened = 0;        // 需要新建连接的请求
+    quint64 m_connectionsReused = 0;        // 复用已有连接的请求
     QString m_authToken;
-    QString m_baseUrl = "http://8.130.152.144:1991/api";
+    QString m_baseUrl = "http://8.130.152.144:1991/api";   // 没有配置服务器时使用
+    ServerSelector* m_servers;
+    QTimer* m_serverProbeTimer;
     QJsonArray m_metaArray;
     QJsonArray m_SchemaMetaArray;
     QJsonObject m_encryptInfo;
     QString m_currentUsername;
+
+    // 登录会话持久化
+    QScopedPointer<AuthSession> m_session;
+    bool m_rememberSession = true;
+    qint64 m_sessionTtlSecs = 0;            // 令牌中没有过期时间时使用
+
+    // 离线提交队列
+    SubmissionJournal* m_journal;
+    QSet<QString> m_syncingSubmissions;     // 正在发送的问卷
+    QTimer* m_syncRetryTimer;               // 发送失败后稍后重试
+    int m_syncRetryAttempt = 0;             // 连续失败次数，决定退避时间
+    int m_maxSyncConcurrency = 2;
+    BodyEncoding m_requestEncoding = BodyEncoding::Identity;
+    bool m_requestCompressionRejected = false;  // 服务器不接受压缩的请求体
+
+    // 分片断点续传
+    ChunkedUploader* m_chunkedUploader;
+    bool m_chunkedUploadEnabled = true;
+    bool m_chunkedUnsupported = false;      // 服务器没有分片接口，本次运行不再尝试
+
+    // 上传调度
+    UploadScheduler* m_uploadScheduler;
+    QHash<quint64, QPointer<QNetworkReply>> m_uploadReplies;    // 正在发送的整文件上传和答案请求
+    QHash<QString, quint64> m_submissionTasks;                  // 问卷id -> 正在排队或发送的任务
+    QHash<quint64, QPair<QString, int>> m_adoptedUploads;       // 已归入提交日志的表单上传 -> (问卷id, 附件下标)
+    QSet<quint64> m_cancelledUploads;
+    QHash<quint64, quint64> m_uploadRequests;                   // 表单上传的请求id -> 任务id
+
+    // 问卷结构缓存
+    QScopedPointer<SchemaCache> m_schemaCache;
+    bool m_schemaCacheEnabled = true;
+
+    // 问卷结构预取
+    QStringList m_schemaPrefetchQueue;
+    QSet<QString> m_schemaPrefetching;          // 正在预取的问卷
+    qint64 m_schemaPrefetchBytes = 0;           // 本次列表刷新已预取的流量
+    qint64 m_schemaPrefetchBudget = 0;
+    int m_schemaPrefetchConcurrency = 2;
+    bool m_schemaPrefetchUnmeteredOnly = false;
 };
 
 #endif // NETWORKMANAGER_H
@@ -0,0 +1,58 @@
+#ifndef QUESTIONPAGEHOST_H
+#define QUESTIONPAGEHOST_H
+
+#include <QObject>
+#include <QStackedWidget>
+#include <QVector>
+#include <QList>
+#include "surveymodel.h"
+#include "questionview.h"
+
+// 虚拟化的题目页面容器
+// 只保留少量页面槽位（当前、上一题和预测的下一题），槽位在题目之间循环使用，
+// 页面数量与问卷题目数量无关。答案保存在答案存储中，页面被回收不会丢失作答内容。
+class QuestionPageHost : public QObject
+{
+    Q_OBJECT
+
+public:
+    QuestionPageHost(QStackedWidget *stackedWidget, QuestionViewPool *viewPool,
+                     int windowSize = 3, QObject *parent = nullptr);
+
+    // 切换问卷，回收所有页面
+    void reset(const SurveyModelPtr& model);
+
+    // 确保题目页面存在，需要时占用一个槽位并从控件池取出题目控件
+    // created返回本次是否新绑定了控件（需要恢复答案）
+    QuestionView *materialize(int questionIndex, bool *created = nullptr);
+    // 显示题目页面
+    void show(int questionIndex);
+    // 只保留给定题目的页面，其余槽位回收
+    void retain(const QList<int>& questionIndexes);
+
+    bool isLive(int questionIndex) const { return slotOf(questionIndex) >= 0; }
+    QuestionView *view(int questionIndex) const;
+    QWidget *page(int questionIndex) const;
+    // 控件所在的题目下标，不在页面上时为-1
+    int indexOfView(const QuestionView *view) const;
+    QList<QuestionView*> liveViews() const;
+
+private:
+    struct PageSlot {
+        QWidget *page = nullptr;
+        QuestionView *view = nullptr;
+        int questionIndex = -1;
+        quint64 lastUsed = 0;
+    };
+
+    int slotOf(int questionIndex) const;
+    void recycle(PageSlot& slot);
+
+    QStackedWidget *m_stackedWidget;
+    QuestionViewPool *m_viewPool;
+    SurveyModelPtr m_model;
+    QVector<PageSlot> m_slots;
+    quint64 m_useCounter = 0;
+};
+
+#endif // QUESTIONPAGEHOST_H
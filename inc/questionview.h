@@ -0,0 +1,278 @@
+#ifndef QUESTIONVIEW_H
+#define QUESTIONVIEW_H
+
+#include <QWidget>
+#include <QGroupBox>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QTextEdit>
+#include <QButtonGroup>
+#include <QAbstractButton>
+#include <QComboBox>
+#include <QSlider>
+#include <QPushButton>
+#include <QJsonObject>
+#include <QHash>
+#include <QVector>
+#include "surveymodel.h"
+
+// 单道题目的显示控件
+// 控件按题型创建一次，翻页时通过bind()绑定到新的题目数据，不再删除重建
+class QuestionView : public QGroupBox
+{
+    Q_OBJECT
+
+public:
+    explicit QuestionView(QuestionType type, QWidget *parent = nullptr);
+
+    QuestionType type() const { return m_type; }
+    QString questionId() const { return m_questionId; }
+
+    // 绑定到题目，清空上一道题的作答状态
+    void bind(const SurveyQuestion& question);
+
+    // 当前作答内容，格式与提交接口中单题的答案一致: {"optionId": "value"}，未作答时为空
+    virtual QJsonObject answer() const = 0;
+    // 按已保存的答案恢复控件状态
+    virtual void setAnswer(const QJsonObject& answer) = 0;
+
+signals:
+    // 用户修改了作答内容
+    void answerEdited();
+
+protected:
+    virtual void bindContent(const SurveyQuestion& question) = 0;
+
+    QVBoxLayout *contentLayout() const { return m_contentLayout; }
+
+private:
+    QuestionType m_type;
+    QString m_questionId;
+    QLabel *m_titleLabel;
+    QLabel *m_descriptionLabel;
+    QVBoxLayout *m_contentLayout;
+};
+
+// 填空题和未识别题型：单行输入
+class LineQuestionView : public QuestionView
+{
+    Q_OBJECT
+
+public:
+    explicit LineQuestionView(QuestionType type, QWidget *parent = nullptr);
+
+    QJsonObject answer() const override;
+    void setAnswer(const QJsonObject& answer) override;
+
+protected:
+    void bindContent(const SurveyQuestion& question) override;
+
+private:
+    QLineEdit *m_lineEdit;
+    QString m_optionId;
+};
+
+// 多行文本题
+class TextareaQuestionView : public QuestionView
+{
+    Q_OBJECT
+
+public:
+    explicit TextareaQuestionView(QWidget *parent = nullptr);
+
+    QJsonObject answer() const override;
+    void setAnswer(const QJsonObject& answer) override;
+
+protected:
+    void bindContent(const SurveyQuestion& question) override;
+
+private:
+    QTextEdit *m_textEdit;
+    QString m_optionId;
+};
+
+// 单选题和多选题，选项可以带填空
+class ChoiceQuestionView : public QuestionView
+{
+    Q_OBJECT
+
+public:
+    explicit ChoiceQuestionView(QuestionType type, QWidget *parent = nullptr);
+
+    QJsonObject answer() const override;
+    void setAnswer(const QJsonObject& answer) override;
+
+protected:
+    void bindContent(const SurveyQuestion& question) override;
+
+private:
+    // 一个选项行，行控件在不同题目间复用，多余的行隐藏
+    struct OptionRow {
+        QWidget *widget;
+        QAbstractButton *button;
+        QLabel *label;
+        QLineEdit *blankEdit;
+        QString optionId;
+        QString blankId;
+        bool hasBlank = false;
+    };
+
+    OptionRow& rowAt(int index);
+
+    QButtonGroup *m_buttonGroup;
+    QVector<OptionRow> m_rows;
+    int m_rowCount = 0;
+    QHash<QString, int> m_rowIndex; // 选项id -> 行下标
+};
+
+// 下拉选择题
+class SelectQuestionView : public QuestionView
+{
+    Q_OBJECT
+
+public:
+    explicit SelectQuestionView(QWidget *parent = nullptr);
+
+    QJsonObject answer() const override;
+    void setAnswer(const QJsonObject& answer) override;
+
+protected:
+    void bindContent(const SurveyQuestion& question) override;
+
+private:
+    QComboBox *m_comboBox;
+};
+
+// 多项填空题
+class MultipleBlankQuestionView : public QuestionView
+{
+    Q_OBJECT
+
+public:
+    explicit MultipleBlankQuestionView(QWidget *parent = nullptr);
+
+    QJsonObject answer() const override;
+    void setAnswer(const QJsonObject& answer) override;
+
+protected:
+    void bindContent(const SurveyQuestion& question) override;
+
+private:
+    struct BlankRow {
+        QWidget *widget;
+        QLabel *label;
+        QLineEdit *lineEdit;
+        QString blankId;
+    };
+
+    QVector<BlankRow> m_rows;
+    int m_rowCount = 0;
+};
+
+// 评分题和NPS题：滑块
+class ScoreQuestionView : public QuestionView
+{
+    Q_OBJECT
+
+public:
+    explicit ScoreQuestionView(QuestionType type, QWidget *parent = nullptr);
+
+    QJsonObject answer() const override;
+    void setAnswer(const QJsonObject& answer) override;
+
+protected:
+    void bindContent(const SurveyQuestion& question) override;
+
+private:
+    QSlider *m_slider;
+};
+
+// 级联题
+class CascaderQuestionView : public QuestionView
+{
+    Q_OBJECT
+
+public:
+    explicit CascaderQuestionView(QWidget *parent = nullptr);
+
+    QJsonObject answer() const override;
+    void setAnswer(const QJsonObject& answer) override;
+
+protected:
+    void bindContent(const SurveyQuestion& question) override;
+
+private:
+    QComboBox *m_firstLevelCombo;
+    QComboBox *m_secondLevelCombo;
+};
+
+// 上传题：文件由表单选择并上传，这里只负责按钮和文件信息
+class UploadQuestionView : public QuestionView
+{
+    Q_OBJECT
+
+public:
+    explicit UploadQuestionView(QWidget *parent = nullptr);
+
+    QJsonObject answer() const override { return QJsonObject(); }
+    void setAnswer(const QJsonObject&) override {}
+
+    void setFileText(const QString& text);
+
+signals:
+    void uploadRequested(const QString& questionId);
+
+protected:
+    void bindContent(const SurveyQuestion& question) override;
+
+private:
+    QLabel *m_fileListLabel;
+};
+
+// 电子签名和扫码题（模拟实现，不产生答案）
+class PlaceholderQuestionView : public QuestionView
+{
+    Q_OBJECT
+
+public:
+    explicit PlaceholderQuestionView(QuestionType type, QWidget *parent = nullptr);
+
+    QJsonObject answer() const override { return QJsonObject(); }
+    void setAnswer(const QJsonObject&) override {}
+
+protected:
+    void bindContent(const SurveyQuestion&) override {}
+};
+
+// 按题型缓存的题目控件池
+// 题目控件只在池中没有可用控件时创建，归还的控件挂在隐藏的容器下等待复用
+class QuestionViewPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit QuestionViewPool(QObject *parent = nullptr);
+    ~QuestionViewPool() override;
+
+    // 取出一个对应题型的控件并绑定到题目
+    QuestionView *acquire(const SurveyQuestion& question);
+    // 归还控件，控件从当前布局中移除并隐藏
+    void release(QuestionView *view);
+
+    int createdCount() const { return m_createdCount; }
+
+signals:
+    // 新创建了控件，用于连接信号
+    void viewCreated(QuestionView *view);
+
+private:
+    QuestionView *create(QuestionType type);
+
+    QWidget *m_parking;
+    QHash<int, QVector<QuestionView*>> m_free; // 题型 -> 可复用控件
+    int m_createdCount = 0;
+};
+
+#endif // QUESTIONVIEW_H
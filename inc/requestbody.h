@@ -0,0 +1,27 @@
+#ifndef REQUESTBODY_H
+#define REQUESTBODY_H
+
+#include <QByteArray>
+#include <QString>
+#include <QJsonObject>
+
+// 请求体压缩方式
+enum class BodyEncoding {
+    Identity,       // 不压缩
+    Deflate,        // zlib格式，Content-Encoding: deflate
+    Gzip            // Content-Encoding: gzip
+};
+
+// 设置中的名称("none"/"deflate"/"gzip")，无法识别时不压缩
+BodyEncoding parseBodyEncoding(const QString& name);
+
+// JSON请求体编码
+// 一律紧凑序列化；请求体不小于minSize时按encoding压缩，压缩后没有变小则发送原文。
+// contentEncoding返回实际使用的Content-Encoding，为空表示没有压缩
+QByteArray encodeRequestBody(const QJsonObject& body, BodyEncoding encoding, QByteArray *contentEncoding = nullptr,
+                             int minSize = 1024);
+
+// 压缩数据，Identity时原样返回
+QByteArray compressBody(const QByteArray& data, BodyEncoding encoding);
+
+#endif // REQUESTBODY_H
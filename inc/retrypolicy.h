@@ -0,0 +1,86 @@
+#ifndef RETRYPOLICY_H
+#define RETRYPOLICY_H
+
+#include <QHash>
+#include <QString>
+#include <QJsonObject>
+#include <QNetworkReply>
+
+// 单个接口的重试策略
+struct RetryPolicy
+{
+    int maxRetries = 0;         // 失败后最多重试次数，0表示不重试
+    int baseDelayMs = 1000;     // 第一次重试前的等待时间
+    int maxDelayMs = 30000;     // 退避等待时间上限
+};
+
+// 单个接口的熔断状态和统计
+struct EndpointHealth
+{
+    enum State {
+        Closed,     // 正常发送
+        Open,       // 熔断中，不发送
+        HalfOpen    // 冷却结束，放行一个探测请求
+    };
+
+    State state = Closed;
+    int consecutiveFailures = 0;
+    int openCount = 0;          // 连续熔断次数，冷却时间随之加倍
+    qint64 openUntil = 0;
+    qint64 probeStartedAt = 0;  // 探测请求发出时间，0表示没有探测请求
+    bool openNoticed = false;   // 本次熔断已提示过用户
+
+    quint64 requests = 0;
+    quint64 failures = 0;
+    quint64 retries = 0;
+    quint64 recovered = 0;      // 重试后成功
+    quint64 rejected = 0;       // 熔断期间被拒绝
+    int lastBackoffMs = 0;
+};
+
+// 按接口的重试与熔断
+// 可重试的失败（连接失败、超时、5xx/429/408）按指数退避加随机抖动重试；
+// 同一接口连续失败达到阈值后熔断，冷却期间直接失败，冷却结束后先放行一个探测请求。
+// 只在NetworkManager线程中使用。
+class RetryController
+{
+public:
+    void setPolicy(const QString& endpoint, const RetryPolicy& policy) { m_policies.insert(endpoint, policy); }
+    RetryPolicy policy(const QString& endpoint) const { return m_policies.value(endpoint); }
+    void setCircuitBreaker(int failureThreshold, int cooldownMs, int maxCooldownMs);
+
+    // 熔断期间返回剩余毫秒数，可以发送时返回0
+    qint64 blockedFor(const QString& endpoint);
+    // 第attempt次重试（从0开始）前的等待时间
+    int backoffDelay(const QString& endpoint, int attempt) const;
+
+    void recordSuccess(const QString& endpoint, int attempt);
+    // 记录一次失败，返回重试前的等待时间；不可重试、次数用完或已熔断时返回-1
+    int recordFailure(const QString& endpoint, int attempt, bool retryable);
+    // 每次熔断只提示一次，之后的失败不再打断用户
+    bool takeOpenNotice(const QString& endpoint);
+    bool isOpen(const QString& endpoint) const;
+    // 切换服务器后，按原服务器累计的失败不再有效，统计数据保留
+    void resetCircuits();
+
+    static bool isRetryable(QNetworkReply::NetworkError error, int httpStatus);
+    // 按响应判断，客户端主动中止的请求不可重试
+    static bool isRetryable(const QNetworkReply *reply);
+    // 主动中止请求。中止与传输超时都表现为OperationCanceledError，只有超时应计入重试和熔断
+    static void abortReply(QNetworkReply *reply);
+    static bool isAbortedByClient(const QNetworkReply *reply);
+
+    // {"endpoint": {"state", "requests", "failures", "retries", "recovered", "rejected", ...}}
+    QJsonObject metrics() const;
+
+private:
+    void open(EndpointHealth& health);
+
+    QHash<QString, RetryPolicy> m_policies;
+    QHash<QString, EndpointHealth> m_health;
+    int m_failureThreshold = 5;
+    int m_cooldownMs = 15000;
+    int m_maxCooldownMs = 300000;
+};
+
+#endif // RETRYPOLICY_H
@@ -0,0 +1,87 @@
+#ifndef RULEENGINE_H
+#define RULEENGINE_H
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QList>
+#include "ruleexpression.h"
+#include "globalrule.h"
+
+class SurveyAnswerStore;
+
+// 问卷逻辑规则引擎
+// 保存加载时编译好的跳转/结束/全局规则，并按规则引用的题目id建立依赖索引。
+// 规则结果在首次求值后缓存，只有其依赖题目的答案变化时才失效重算。
+class SurveyRuleEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SurveyRuleEngine(SurveyAnswerStore *answers, QObject *parent = nullptr);
+
+    void setOptionTitleLookup(const RuleExpression::OptionTitleLookup& lookup);
+
+    // 清空所有规则、依赖索引和缓存
+    void clear();
+
+    // 按可见题目顺序添加每道题的跳转和结束规则，下标与可见题目一致
+    void addQuestionRules(const RuleExpression& jumpRule, const RuleExpression& finishRule);
+    void addGlobalRule(const GlobalRule& rule);
+
+    int questionCount() const { return m_jumpRules.size(); }
+    int globalRuleCount() const { return m_globalRules.size(); }
+    const RuleExpression& jumpRule(int questionIndex) const { return m_jumpRules[questionIndex]; }
+    const GlobalRule& globalRule(int ruleIndex) const { return m_globalRules[ruleIndex]; }
+
+    // 跳转规则条件是否满足（无规则时为false）
+    bool jumpRuleMatched(int questionIndex);
+    // 结束规则条件是否满足（无规则时为false）
+    bool finishRuleMatched(int questionIndex);
+    // 全局规则结果：结构化规则为条件是否满足，表达式规则为表达式的值
+    bool globalRuleResult(int ruleIndex);
+
+    // 读取某道题答案的规则数量
+    int dependentRuleCount(const QString& questionId) const { return m_dependents.value(questionId).size(); }
+
+private slots:
+    void onAnswerChanged(const QString& questionId);
+
+private:
+    enum RuleKind {
+        JumpRule,
+        FinishRule,
+        GlobalRuleKind
+    };
+
+    // 缓存状态
+    enum CachedResult : qint8 {
+        NotCached = -1,
+        ResultFalse = 0,
+        ResultTrue = 1
+    };
+
+    struct RuleRef {
+        RuleKind kind;
+        int index;
+    };
+
+    void addDependencies(const QStringList& questionIds, RuleKind kind, int index);
+    bool evaluate(const RuleExpression& rule) const;
+
+    SurveyAnswerStore *m_answers;
+    RuleExpression::OptionTitleLookup m_optionTitle;
+
+    QVector<RuleExpression> m_jumpRules;
+    QVector<RuleExpression> m_finishRules;
+    QList<GlobalRule> m_globalRules;
+
+    QVector<CachedResult> m_jumpResults;
+    QVector<CachedResult> m_finishResults;
+    QVector<CachedResult> m_globalResults;
+
+    // 题目id -> 读取该题答案的规则
+    QHash<QString, QVector<RuleRef>> m_dependents;
+};
+
+#endif // RULEENGINE_H
@@ -0,0 +1,48 @@
+#ifndef RULEEXPRESSION_H
+#define RULEEXPRESSION_H
+
+#include <QString>
+#include <QStringList>
+#include <QSharedPointer>
+#include <functional>
+
+class SurveyAnswerStore;
+
+// 逻辑规则表达式（jumpRule / finishRule / globalRule）
+// 问卷加载时编译成语法树，答题过程中直接对答案存储求值，不再构造正则
+// 支持: #{题目id} / #{题目id.子字段}、字符串、数字、true/false、
+//       == != > >= < <=、&& || !、括号、includes(a, b)、jump('题目id')
+class RuleExpression
+{
+public:
+    // 根据题目id和选项id查找选项标题，用于 #{q1} == #{q1.opt1} 形式的比较
+    using OptionTitleLookup = std::function<QString(const QString&, const QString&)>;
+
+    // 语法树节点，定义在ruleexpression.cpp中
+    struct Node;
+
+    RuleExpression() = default;
+
+    static RuleExpression compile(const QString& source);
+
+    bool isValid() const { return !m_root.isNull(); }
+    QString source() const { return m_source; }
+    QString errorString() const { return m_error; }
+
+    // jump('id') 指定的跳转目标；没有jump时取独立出现的字符串字面量，如 "true && 'q5'"
+    QString jumpTarget() const { return m_jumpTarget; }
+    // 表达式中引用到的题目id（去重）
+    QStringList referencedQuestions() const { return m_references; }
+
+    bool evaluate(const SurveyAnswerStore& answers,
+                  const OptionTitleLookup& optionTitle = OptionTitleLookup()) const;
+
+private:
+    QString m_source;
+    QString m_error;
+    QString m_jumpTarget;
+    QStringList m_references;
+    QSharedPointer<const Node> m_root;
+};
+
+#endif // RULEEXPRESSION_H
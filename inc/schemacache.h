@@ -0,0 +1,62 @@
+#ifndef SCHEMACACHE_H
+#define SCHEMACACHE_H
+
+#include <QHash>
+#include <QString>
+#include <QByteArray>
+#include <QJsonObject>
+#include "surveymodel.h"
+
+// 缓存的问卷结构
+struct CachedSchema
+{
+    QString projectId;
+    QString updateAt;           // 下载时项目列表中的更新时间
+    QString etag;               // 服务器返回的ETag/Last-Modified，用于条件请求
+    QString lastModified;
+    QByteArray digest;          // 问卷结构的摘要，判断重新下载的内容是否变化
+    qint64 fetchedAt = 0;
+    QJsonObject schema;         // loadProject返回的data对象
+    SurveyModelPtr model;       // 编译好的问卷模型，只在内存中保留
+};
+
+// 问卷结构磁盘缓存
+// 每个项目一个文件，记录下载时的updateAt和ETag。项目列表中的updateAt与缓存一致时直接使用缓存，
+// 否则带If-None-Match/If-Modified-Since重新请求，服务器返回304或内容相同时不再重新编译和渲染。
+// 只在NetworkManager线程中使用。
+class SchemaCache
+{
+public:
+    explicit SchemaCache(const QString& directory);
+
+    // 项目列表中的更新时间
+    void setServerVersion(const QString& projectId, const QString& updateAt);
+    QString serverVersion(const QString& projectId) const { return m_serverVersions.value(projectId); }
+
+    // 读取缓存（第一次访问时从磁盘加载），没有缓存返回nullptr
+    const CachedSchema *entry(const QString& projectId);
+    // 缓存的模型，需要时才编译
+    SurveyModelPtr model(const QString& projectId);
+
+    // 已知服务器版本且与缓存一致，不需要重新请求
+    bool isFresh(const QString& projectId);
+    // 缓存与项目列表中的版本不一致
+    bool isStale(const QString& projectId);
+
+    // 保存下载的问卷结构，返回内容是否与缓存不同
+    bool store(const QString& projectId, const QJsonObject& schema, const QString& updateAt,
+               const QString& etag, const QString& lastModified);
+    // 服务器返回304，缓存内容仍然有效
+    void revalidated(const QString& projectId, const QString& updateAt);
+    void remove(const QString& projectId);
+
+private:
+    QString filePath(const QString& projectId) const;
+    bool save(const CachedSchema& entry) const;
+
+    QString m_directory;
+    QHash<QString, CachedSchema> m_entries;         // 已加载的缓存
+    QHash<QString, QString> m_serverVersions;       // 项目id -> 项目列表中的updateAt
+};
+
+#endif // SCHEMACACHE_H
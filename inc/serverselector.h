@@ -0,0 +1,68 @@
+#ifndef SERVERSELECTOR_H
+#define SERVERSELECTOR_H
+
+#include <QObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QJsonObject>
+#include <QStringList>
+#include <QSet>
+#include <QUrl>
+
+// 单个服务器地址的状态
+struct ServerStatus
+{
+    QString baseUrl;
+    double latencyMs = -1;          // 探测往返时间的滑动平均，-1表示还没有结果
+    int consecutiveFailures = 0;
+    bool healthy = true;            // 还没有探测时视为可用，按配置顺序使用
+
+    quint64 probes = 0;
+    quint64 probeFailures = 0;
+    quint64 failovers = 0;          // 因为不可用被切换走的次数
+};
+
+// 多个镜像服务器的选择
+// 后台同时探测各地址的 /system，按延迟的滑动平均选择可用且最快的一个；
+// 请求连续连接失败时把当前服务器标记为不可用并立即切换到下一个。
+// 当前服务器仍然可用时，只有明显更快（延迟低30%以上）才切换，避免来回跳。
+// 只在NetworkManager线程中使用。
+class ServerSelector : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ServerSelector(QNetworkAccessManager *networkManager, QObject *parent = nullptr);
+
+    // preferred为上次使用的地址，在列表中时优先使用
+    void setServers(const QStringList& baseUrls, const QString& preferred = QString());
+    QString current() const;
+    int serverCount() const { return m_servers.size(); }
+    void setProbeTimeout(int timeoutMs) { m_probeTimeoutMs = qMax(500, timeoutMs); }
+
+    // 同时探测所有地址，全部返回后重新选择
+    void probe();
+    // 普通请求的结果，url为请求地址
+    void reportSuccess(const QUrl& url);
+    void reportFailure(const QUrl& url);
+
+    // {"current", "servers": [{"baseUrl", "latencyMs", "healthy", "probes", "probeFailures", "failovers", "current"}]}
+    QJsonObject metrics() const;
+
+signals:
+    void currentChanged(const QString& baseUrl);
+
+private:
+    void onProbeFinished(QNetworkReply *reply, int index, qint64 elapsedMs);
+    void markFailed(ServerStatus& server, int failureThreshold);
+    int indexOf(const QUrl& url) const;
+    void select();
+
+    QNetworkAccessManager *m_networkManager;
+    QList<ServerStatus> m_servers;
+    int m_current = 0;
+    int m_probeTimeoutMs = 5000;
+    QSet<int> m_probing;            // 还没有返回的探测
+};
+
+#endif // SERVERSELECTOR_H
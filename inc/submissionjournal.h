@@ -0,0 +1,76 @@
+#ifndef SUBMISSIONJOURNAL_H
+#define SUBMISSIONJOURNAL_H
+
+#include <QObject>
+#include <QHash>
+#include <QStringList>
+#include <QJsonObject>
+#include <QJsonArray>
+
+// 一份等待提交的问卷
+struct PendingSubmission
+{
+    QString id;
+    QString projectId;
+    QJsonObject request;        // saveAnswer请求体，提交时间和位置在入队时确定
+    // 未上传的附件: [{"field", "subField", "path", "fileId", "skipped"}]，上传成功后记录fileId
+    QJsonArray attachments;
+    qint64 createdAt = 0;
+    bool rejected = false;      // 服务器拒绝，不再自动重试
+    QString rejectReason;
+
+    // 还没有上传的附件下标
+    QList<int> pendingAttachments() const;
+    // 合并已上传附件后的请求体
+    QJsonObject requestBody() const;
+};
+
+// 离线提交日志
+// 每份问卷在发送前追加写入本地日志文件（每行一条JSON记录），服务器确认后再追加确认记录。
+// 启动时按顺序重放日志恢复未确认的问卷，崩溃或断网都不会丢失已提交的答案。
+// 已确认的记录积累到一定数量后重写日志文件，只保留未确认的问卷。
+class SubmissionJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SubmissionJournal(const QString& filePath, QObject *parent = nullptr);
+
+    // 从日志文件恢复未确认的问卷，写了一半的记录会被忽略并从文件中清除
+    bool load();
+
+    // 追加一份问卷，写入磁盘后返回id，写入失败返回空字符串
+    QString append(const QString& projectId, const QJsonObject& request, const QJsonArray& attachments);
+    // 记录附件上传成功，fileId为空表示放弃这个附件
+    bool markAttachmentUploaded(const QString& id, int attachmentIndex, const QString& fileId);
+    // 服务器已确认，删除这份问卷
+    bool acknowledge(const QString& id);
+    // 服务器拒绝，保留问卷但不再自动重试
+    bool markRejected(const QString& id, const QString& reason);
+
+    // 等待提交的问卷id（不含被拒绝的），按入队顺序
+    QStringList pendingIds() const;
+    const PendingSubmission *entry(const QString& id) const;
+    int pendingCount() const;
+    int rejectedCount() const { return m_entries.size() - pendingCount(); }
+
+    QString filePath() const { return m_filePath; }
+
+signals:
+    void pendingCountChanged(int count);
+
+private:
+    bool writeRecord(const QJsonObject& record);
+    void applyRecord(const QJsonObject& record);
+    void compactIfNeeded();
+    // 只保留未确认的问卷重写日志文件
+    void compact();
+
+    QString m_filePath;
+    QHash<QString, PendingSubmission> m_entries;
+    QStringList m_order;        // 入队顺序
+    int m_recordCount = 0;      // 日志文件中的记录数量
+    bool m_partialTail = false; // 日志文件以没有换行符的半条记录结尾
+};
+
+#endif // SUBMISSIONJOURNAL_H
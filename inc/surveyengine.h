@@ -0,0 +1,82 @@
+#ifndef SURVEYENGINE_H
+#define SURVEYENGINE_H
+
+#include <QObject>
+#include <QJsonObject>
+#include <QJsonArray>
+#include "surveymodel.h"
+#include "answerstore.h"
+#include "ruleengine.h"
+#include "uploadjobtable.h"
+
+// 一次翻页或提交操作的决策结果
+struct SurveyNavigation
+{
+    enum Action {
+        Stay,            // 不移动（已在第一题或最后一题）
+        Goto,            // 显示targetIndex指定的题目
+        Submit,          // 满足结束规则或点击提交，提交问卷
+        RequiredMissing, // 当前题是必填题但未作答
+        RuleRejected     // 全局表达式规则不通过
+    };
+
+    Action action = Stay;
+    int targetIndex = -1;
+
+    static QString actionName(Action action);
+};
+
+// 问卷答题引擎，只依赖QtCore
+// 负责问卷模型、答案、跳转/结束/全局规则、必答检查和提交数据的组装，
+// 界面只负责显示题目和把作答内容交给引擎。回放工具直接驱动本类。
+class SurveyEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SurveyEngine(QObject *parent = nullptr);
+
+    // 切换问卷，清空答案并回到第一题
+    void setModel(const SurveyModelPtr& model);
+    SurveyModelPtr model() const { return m_model; }
+
+    SurveyAnswerStore *answers() const { return m_answers; }
+    SurveyRuleEngine *rules() const { return m_rules; }
+
+    int currentIndex() const { return m_currentIndex; }
+    void setCurrentIndex(int questionIndex);
+
+    // 写入某道题的答案，返回答案是否发生变化
+    bool setAnswer(const QString& questionId, const QJsonObject& answer);
+
+    bool isRequired(int questionIndex) const;
+    bool isAnswered(int questionIndex) const;
+
+    // 只按跳转规则预测某道题之后显示的题目，不检查必答和全局规则
+    int predictNextIndex(int questionIndex);
+
+    // 点击下一题：依次检查必答、全局规则、结束规则和跳转规则，Goto时移动当前题目
+    SurveyNavigation next();
+    // 点击上一题
+    SurveyNavigation previous();
+    // 点击提交：只检查当前题是否必答
+    SurveyNavigation submit();
+
+    // 提交接口需要的答案数据
+    // uploads中已上传的文件写入上传题答案，location为位置题的取值
+    QJsonObject submitPayload(const UploadJobTable *uploads = nullptr,
+                              const QString& location = QString()) const;
+
+    // 单选/多选题提交时只写选项id，不附带选项文字（与下拉题格式相同），答案存储和规则计算不受影响
+    void setCompactChoiceAnswers(bool compact) { m_compactChoiceAnswers = compact; }
+    bool compactChoiceAnswers() const { return m_compactChoiceAnswers; }
+
+private:
+    SurveyModelPtr m_model;
+    SurveyAnswerStore *m_answers;
+    SurveyRuleEngine *m_rules;
+    int m_currentIndex = 0;
+    bool m_compactChoiceAnswers = false;
+};
+
+#endif // SURVEYENGINE_H
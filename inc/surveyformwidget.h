@@ -25,6 +25,7 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QMap>
+#include <QMultiHash>
 #include <QStackedWidget>
 #include <QList>
 #include <QProgressBar>
@@ -42,26 +43,37 @@
 #include "permissionmanager.h"
 #include "locationmanager.h"
 #include "functionlogger.h"
+#include "surveyengine.h"
+#include "surveymodel.h"
+#include "questionview.h"
+#include "questionpagehost.h"
+#include "uploadscheduler.h"
 
 class SurveyFormWidget : public QWidget
 {
     Q_OBJECT
+    friend class SurveyFormBenchmark; // 性能测试工具直接驱动翻页流程
 
 public:
     explicit SurveyFormWidget(QWidget *parent = nullptr);
 
-    void setSurveySchema(const QJsonObject& schema);
+    // 设置在网络线程中编译好的问卷模型并渲染，第一次显示题目时开始答题
+    void setSurveyModel(const SurveyModelPtr& model);
+    // 受访者已经作答或选择了文件，自动写入的默认答案和自动拍摄的照片不算
+    bool hasUserEdits() const;
 
     qint64 GetDiffTime(){return m_endTime - m_startTime;}
 
 public slots:
-    void handleUploadSuccsee(const QJsonObject& response);
-    void handleUploadFailed(const QString& error);
+    void handleUploadSuccsee(quint64 requestId, const QJsonObject& response);
+    void handleUploadFailed(quint64 requestId, const QString& error);
+    void handleUploadProgress(quint64 requestId, qint64 bytesSent, qint64 bytesTotal);
 
 signals:
-    void submitSurvey(const QJsonObject& data);
+    // attachments为还没有上传成功的附件: [{"field", "subField", "path"}]，由提交队列补传
+    void submitSurvey(const QJsonObject& data, const QJsonArray& attachments);
     void startSurvey();
-    void UploadFile(QString , QString, QString);
+    void UploadFile(quint64 requestId, QString , QString, QString, UploadPriority);
     void backToSurveyList(); // 添加返回问卷列表信号
 
 protected:
@@ -78,9 +90,6 @@ private slots:
     void onNextClicked();
     void onPrevClicked();
     void onBackToSurveyListClicked();
-    void evaluateJumpLogic(int currentQuestionIndex);
-    bool evaluateFinishRule(int currentQuestionIndex); // 添加结束规则评估函数
-    bool evaluateGlobalRules(); // 添加全局规则评估函数
     void updateRecordTime(qint64 duration);
     void handleRecorderError();
     
@@ -89,24 +98,25 @@ private slots:
     void onCameraActiveChanged();
 
 private:
-    void renderSurvey(const QJsonObject& schema);
+    // 按当前问卷模型重新绑定页面并回到第一题
+    void renderSurvey();
+    // 开始答题：计时、定位、录音和自动拍照
+    void startSession();
     void renderQuestionPage(int questionIndex);
-    void handleUploadButton(QPushButton* uploadButton, const QString& field);
+    void handleUploadButton(const QString& field);
     QJsonObject collectAnswers();
-    int getNextQuestionIndex(int currentQuestionIndex);
-    bool isQuestionAnswered(int questionIndex);
-    bool isQuestionRequired(int questionIndex);
+    QJsonArray pendingAttachments() const;
+    void showQuestion(int questionIndex);
     void updateProgress(int num); // 添加更新进度条的方法
     void updateScrollBarVisibility();
     void adjustScrollBarRange(int pageHeight);
     void ensureLayoutCalculated(); // 磣保布局计算完成
-    void AddFile(QString id, QString path);
-    void saveCurrentAnswer(int questionIndex);
+    // 登记待上传的文件，返回上传请求id
+    quint64 AddFile(QString id, QString path);
     void restoreAnswer(int questionIndex);
-    QJsonObject collectSingleQuestionAnswer(int questionIndex);
-    QString getAnswerValue(const QJsonObject& savedAnswer, const QString& field);
-    QLineEdit* findAssociatedLineEdit(QWidget* optionWidget);
-    void processOptionsWithBlankInputs(QWidget* page, const QString& field, QJsonObject& answer);
+    void onAnswerEdited(int questionIndex);
+    void schedulePrefetch();
+    void prefetchNextPage();
 
     // 录音相关
     void requestAudioPermission();
@@ -118,11 +128,8 @@ private:
     void initializeCamera();
     void startAutoCapture();
     void stopAutoCapture();
-    
-    // 添加处理逻辑规则的函数
-    bool evaluateExpression(const QString& expression, const QJsonObject& answers);
-    bool evaluateGlobalRuleConditions(const QJsonObject& rule, const QJsonObject& currentAnswers); // 添加全局规则条件评估函数
-    int findQuestionIndexById(const QString& questionId);
+    // 把一张照片加入上传队列，已经加入过的返回false
+    bool uploadCapturedPhoto(const QString& filePath);
     
     // 添加滚动和触摸相关变量
     QScrollArea *m_scrollArea;
@@ -131,13 +138,10 @@ private:
     QWidget *m_scrollWidget;
     qint64 m_startTime;
     qint64 m_endTime;
-    QJsonObject m_schema;
+    SurveyModelPtr m_model;  // 编译后的问卷模型，只读
     
     // 文件上传相关
-    // QMap<QString, QString> m_selectedFiles; // field -> file path
-    QJsonArray m_selectedFiles;
-    QMap<QString, QLabel*> m_fileLabels;    // field -> file list label
-    QJsonArray m_uploadedFiles; // field -> uploaded file info
+    UploadJobTable m_uploadJobs;    // 上传请求id -> 附件上传任务
     
     // 触摸和滚动相关变量
     QPoint m_lastTouchPoint;
@@ -146,15 +150,18 @@ private:
     
     // 分页相关变量
     CustomStackedWidget *m_stackedWidget;
-    QList<QWidget*> m_questionPages;
-    QList<QJsonObject> m_questions;
-    QList<QJsonObject> m_showQuestions;
+    QuestionViewPool *m_viewPool;            // 按题型复用的题目控件
+    QuestionPageHost *m_pageHost;            // 只保留当前和相邻题目的页面
+    QTimer *m_prefetchTimer;                 // 空闲时预先构建预测的下一题页面
+    int m_prefetchIndex = -1;                // 已预先构建的题目下标
     QPushButton *m_prevButton;
     QPushButton *m_nextButton;
     QPushButton *m_submitButton;
     QPushButton *m_backToListButton;
     int m_currentQuestionIndex;
-    QList<QString> m_globalRules;
+
+    // 答案、逻辑规则和翻页决策，不依赖界面
+    SurveyEngine *m_engine;
     
     // 进度条相关变量
     QProgressBar *m_progressBar;
@@ -166,25 +173,18 @@ private:
     QAudioInput *audioInput;
     QMediaRecorder *mediaRecorder;
     QString m_output;
-    QJsonObject m_autoUpLoadObj;
     
     // 拍照相关
     QCamera *m_camera;
     QTimer *m_captureTimer;
     QDir m_photoDir;
     bool m_autoCaptureEnabled;
-    QList<QString> m_capturedPhotos; // 存储已拍摄照片的路径
+    QList<QString> m_capturedPhotos; // 已加入上传队列的照片路径
 
-    // 添加上传状态标志
-    bool m_isUploading = false;  // 标记是否有文件正在上传
-    int m_pendingUploads = 0;    // 记录待上传的文件数量
-    bool m_shouldSubmitAfterUpload = false; // 标记是否应该在上传完成后提交
-    
     // 答案存储相关
-    QMap<int, QJsonObject> m_answerCache; // 存储每个题目的答案
-
-    // 位置信息题目
-    QJsonObject m_locationObj;
+    bool m_isRestoring = false;        // 恢复答案期间不回写答案存储
+    bool m_userEdited = false;         // 受访者修改过答案或选择过文件
+    bool m_sessionStarted = false;     // 已经开始答题，问卷结构更新时不再重新开始
 };
 
 #endif // SURVEYFORMWIDGET_H
@@ -0,0 +1,123 @@
+#ifndef SURVEYMODEL_H
+#define SURVEYMODEL_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <QJsonObject>
+#include <QSharedPointer>
+#include <QMetaType>
+#include "ruleexpression.h"
+#include "globalrule.h"
+
+// 题型，对应SurveyKing题目的type字段
+enum class QuestionType {
+    FillBlank,
+    Textarea,
+    Radio,
+    Checkbox,
+    Select,
+    MultipleBlank,
+    Score,
+    Nps,
+    Cascader,
+    Upload,
+    Signature,
+    Barcode,
+    Other
+};
+
+// 题目的一个选项（children中的一项）
+struct SurveyOption
+{
+    QString id;
+    QString title;
+    bool hasBlank = false;  // 选项带填空（attribute.dataType == "horzBlank"）
+    QString blankId;        // 选项中填空的id
+};
+
+// 编译后的题目
+struct SurveyQuestion
+{
+    QString id;
+    QString title;
+    QString description;
+    QString typeName;
+    QuestionType type = QuestionType::Other;
+    bool required = false;
+    bool hidden = false;
+    int visibleIndex = -1;              // 在可见题目中的下标，隐藏题目为-1
+    QVector<SurveyOption> options;
+    QHash<QString, int> optionIndex;    // 选项id -> options下标
+    QString uploadSubField;             // 上传题答案使用的子字段（最后一个带id的选项）
+
+    bool isType(QuestionType t) const { return type == t; }
+    int indexOfOption(const QString& optionId) const { return optionIndex.value(optionId, -1); }
+    QString optionTitle(const QString& optionId) const;
+};
+
+// 编译后的问卷模型
+// 在NetworkManager工作线程中由/public/loadProject的响应构建一次，之后只读，
+// 界面线程按下标和id直接访问，不再反复按字符串读取JSON字段
+class SurveyModel
+{
+public:
+    SurveyModel() = default;
+
+    // schema为loadProject返回的data对象
+    static QSharedPointer<const SurveyModel> build(const QJsonObject& schema);
+
+    QString id() const { return m_id; }
+    QString name() const { return m_name; }
+    QString title() const { return m_title; }
+    QString description() const { return m_description; }
+
+    // 全部题目（含隐藏题目）
+    const QVector<SurveyQuestion>& questions() const { return m_questions; }
+
+    // 可见题目
+    int visibleCount() const { return m_visible.size(); }
+    const SurveyQuestion& visibleQuestion(int visibleIndex) const { return m_questions[m_visible[visibleIndex]]; }
+    int visibleIndexOf(const QString& questionId) const;
+
+    // 按题目id查找，找不到返回nullptr
+    const SurveyQuestion* question(const QString& questionId) const;
+    QString optionTitle(const QString& questionId, const QString& optionId) const;
+
+    // 自动上传录音/拍照文件和位置信息的隐藏题目，没有时返回nullptr
+    const SurveyQuestion* autoUploadQuestion() const { return m_autoUploadIndex >= 0 ? &m_questions[m_autoUploadIndex] : nullptr; }
+    const SurveyQuestion* locationQuestion() const { return m_locationIndex >= 0 ? &m_questions[m_locationIndex] : nullptr; }
+
+    // 预编译的逻辑规则，跳转/结束规则下标与可见题目一致
+    const QVector<RuleExpression>& jumpRules() const { return m_jumpRules; }
+    const QVector<RuleExpression>& finishRules() const { return m_finishRules; }
+    // 跳转规则目标题目在可见题目中的下标，没有目标时为-1
+    int jumpTargetIndex(int visibleIndex) const { return m_jumpTargets.value(visibleIndex, -1); }
+    const QList<GlobalRule>& globalRules() const { return m_globalRules; }
+
+    static QuestionType parseType(const QString& typeName);
+
+private:
+    QString m_id;
+    QString m_name;
+    QString m_title;
+    QString m_description;
+
+    QVector<SurveyQuestion> m_questions;
+    QVector<int> m_visible;             // 可见题目在m_questions中的下标
+    QHash<QString, int> m_questionIndex; // 题目id -> m_questions下标
+    int m_autoUploadIndex = -1;
+    int m_locationIndex = -1;
+
+    QVector<RuleExpression> m_jumpRules;
+    QVector<RuleExpression> m_finishRules;
+    QVector<int> m_jumpTargets;
+    QList<GlobalRule> m_globalRules;
+};
+
+using SurveyModelPtr = QSharedPointer<const SurveyModel>;
+Q_DECLARE_METATYPE(SurveyModelPtr)
+
+#endif // SURVEYMODEL_H
@@ -0,0 +1,65 @@
+#ifndef UPLOADJOBTABLE_H
+#define UPLOADJOBTABLE_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QJsonObject>
+
+// 一个附件上传任务
+struct UploadJob
+{
+    enum State {
+        Pending,        // 已加入上传队列
+        Uploading,      // 正在发送
+        Uploaded,       // 服务器已返回文件id
+        Failed          // 上传失败，提交时交给提交队列补传
+    };
+
+    quint64 id = 0;             // 上传请求id
+    QString questionId;
+    QString subField;           // 上传题答案中的子字段
+    QString path;               // 本地路径
+    State state = Pending;
+    qint64 bytesSent = 0;
+    qint64 bytesTotal = 0;
+    QString fileId;             // 服务器文件id
+
+    bool isFinished() const { return state == Uploaded; }
+};
+
+// 附件上传任务表
+// 按上传请求id和题目id索引，上传进度和结果都是O(1)更新，
+// 提交时直接把已上传的文件id写入答案，不需要重新扫描和拼装上传结果数组
+class UploadJobTable
+{
+public:
+    UploadJob& add(quint64 id, const QString& questionId, const QString& subField, const QString& path);
+    void clear();
+
+    UploadJob *job(quint64 id);
+    const UploadJob *job(quint64 id) const;
+    bool contains(quint64 id) const { return m_jobs.contains(id); }
+
+    bool setProgress(quint64 id, qint64 bytesSent, qint64 bytesTotal);
+    bool markUploaded(quint64 id, const QString& fileId);
+    bool markFailed(quint64 id);
+
+    // 某道题的全部上传任务，按加入顺序
+    QList<const UploadJob*> jobsForQuestion(const QString& questionId) const;
+    // 还没有上传成功的任务，按加入顺序
+    QList<const UploadJob*> unfinishedJobs() const;
+    int count() const { return m_jobs.size(); }
+    int uploadedCount() const { return m_uploadedCount; }
+
+    // 把已上传的文件id按服务器要求的格式写入答案: {"questionId": {"subField": ["fileId"]}}
+    void applyToAnswers(QJsonObject& answers) const;
+
+private:
+    QHash<quint64, UploadJob> m_jobs;
+    QHash<QString, QList<quint64>> m_byQuestion;    // 题目id -> 上传请求id
+    QList<quint64> m_order;                         // 加入顺序
+    int m_uploadedCount = 0;
+};
+
+#endif // UPLOADJOBTABLE_H
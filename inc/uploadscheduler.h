@@ -0,0 +1,74 @@
+#ifndef UPLOADSCHEDULER_H
+#define UPLOADSCHEDULER_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QVariantMap>
+#include <atomic>
+
+// 上传优先级，数值越小越先发送
+enum class UploadPriority {
+    Answer = 0,     // 问卷答案(saveAnswer)
+    UserFile,       // 用户在上传题中选择的文件
+    Audio,          // 自动录音
+    Photo           // 自动拍照
+};
+Q_DECLARE_METATYPE(UploadPriority)
+
+// 上传请求id，由发起上传的界面生成，上传结果信号带回同一个id，按id直接找到对应的文件
+inline quint64 nextUploadRequestId()
+{
+    static std::atomic<quint64> requestId{0};
+    return ++requestId;
+}
+
+// 上传调度
+// 所有上传和提交请求先进入按优先级划分的队列，同时发送的请求数量不超过并发上限，
+// 避免几十张自动拍照的照片同时占满移动网络，拖慢问卷答案的提交。
+// 调度器只负责排队，任务开始时发出taskStarted，由网络管理器发送请求，完成后调用finish释放名额。
+class UploadScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UploadScheduler(QObject *parent = nullptr);
+
+    void setMaxConcurrent(int maxConcurrent);
+    int maxConcurrent() const { return m_maxConcurrent; }
+    // 单个优先级同时发送的上限，低优先级的后台上传只占用部分带宽
+    void setPriorityLimit(UploadPriority priority, int limit);
+
+    // 加入队列，返回任务id。task由调用方定义，taskStarted时原样带回
+    quint64 enqueue(UploadPriority priority, const QVariantMap& task);
+    // 取消还在排队的任务，已经开始的任务返回false，需要调用方中止请求
+    bool cancel(quint64 id);
+    // 任务结束（成功、失败或中止），释放并发名额
+    void finish(quint64 id);
+
+    bool isQueued(quint64 id) const { return m_tasks.contains(id) && !m_running.contains(id); }
+    bool isRunning(quint64 id) const { return m_running.contains(id); }
+    QVariantMap task(quint64 id) const { return m_tasks.value(id); }
+    QList<quint64> taskIds() const { return m_tasks.keys(); }
+
+    int queuedCount() const { return m_tasks.size() - m_running.size(); }
+    int runningCount() const { return m_running.size(); }
+
+signals:
+    void taskStarted(quint64 id, const QVariantMap& task);
+    void queueDepthChanged(int queued, int running);
+
+private:
+    void dispatch();
+
+    static const int PriorityCount = int(UploadPriority::Photo) + 1;
+    QList<quint64> m_queues[PriorityCount];     // 每个优先级内先进先出
+    QHash<quint64, QVariantMap> m_tasks;        // 排队和正在发送的任务
+    QHash<quint64, UploadPriority> m_running;  // 正在发送的任务 -> 优先级
+    int m_priorityLimits[PriorityCount] = {};   // 0表示只受总并发限制
+    quint64 m_nextId = 1;
+    int m_maxConcurrent = 2;
+    bool m_dispatching = false;
+};
+
+#endif // UPLOADSCHEDULER_H
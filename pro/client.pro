@@ -34,7 +34,16 @@ SOURCES += \
     ../src/settingswidget.cpp \
     ../src/permissionmanager.cpp \
     ../src/locationmanager.cpp \
-    ../src/globalstyle.cpp
+    ../src/globalstyle.cpp \
+    ../src/questionview.cpp \
+    ../src/questionpagehost.cpp \
+    ../src/submissionjournal.cpp \
+    ../src/chunkeduploader.cpp \
+    ../src/uploadscheduler.cpp \
+    ../src/schemacache.cpp \
+    ../src/retrypolicy.cpp \
+    ../src/authsession.cpp \
+    ../src/serverselector.cpp
 
 HEADERS += \
     ../inc/CustomUI.h \
@@ -50,7 +59,19 @@ HEADERS += \
     ../inc/permissionmanager.h \
     ../inc/locationmanager.h \
     ../inc/functionlogger.h \
-    ../inc/globalstyle.h
+    ../inc/globalstyle.h \
+    ../inc/questionview.h \
+    ../inc/questionpagehost.h \
+    ../inc/submissionjournal.h \
+    ../inc/chunkeduploader.h \
+    ../inc/uploadscheduler.h \
+    ../inc/schemacache.h \
+    ../inc/retrypolicy.h \
+    ../inc/authsession.h \
+    ../inc/serverselector.h
+
+# 问卷引擎（模型、逻辑规则、答案和翻页决策），与回放工具共用同一份源文件列表
+include(surveyengine.pri)
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -0,0 +1,19 @@
+# 多服务器切换验证工具：用本地替身服务器检查ServerSelector的探测排序、故障切换和恢复
+QT = core network
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = serverfailover
+TEMPLATE = app
+
+INCLUDEPATH += ../inc ../tools/standin
+
+SOURCES += \
+    ../tools/serverfailover/main.cpp \
+    ../tools/standin/standinserver.cpp \
+    ../src/serverselector.cpp
+
+HEADERS += \
+    ../tools/standin/standinserver.h \
+    ../inc/serverselector.h
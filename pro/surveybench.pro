@@ -0,0 +1,37 @@
+# 问卷表单性能测试：生成问卷并在offscreen平台上驱动SurveyFormWidget，结果以JSON输出
+QT += core gui widgets network multimedia positioning
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = surveybench
+TEMPLATE = app
+
+INCLUDEPATH += ../inc ../tools/surveybench
+
+SOURCES += \
+    ../tools/surveybench/main.cpp \
+    ../tools/surveybench/schemagenerator.cpp \
+    ../src/surveyformwidget.cpp \
+    ../src/questionview.cpp \
+    ../src/questionpagehost.cpp \
+    ../src/CustomUI.cpp \
+    ../src/locationmanager.cpp \
+    ../src/permissionmanager.cpp \
+    ../src/settingsmanager.cpp \
+    ../src/logfilemanager.cpp
+
+HEADERS += \
+    ../tools/surveybench/schemagenerator.h \
+    ../inc/surveyformwidget.h \
+    ../inc/questionview.h \
+    ../inc/questionpagehost.h \
+    ../inc/CustomUI.h \
+    ../inc/locationmanager.h \
+    ../inc/permissionmanager.h \
+    ../inc/settingsmanager.h \
+    ../inc/logfilemanager.h \
+    ../inc/functionlogger.h
+
+# 表单使用的问卷引擎源文件
+include(surveyengine.pri)
@@ -0,0 +1,24 @@
+# 问卷引擎源文件列表
+# 只依赖QtCore，由客户端、引擎静态库(surveyengine.pro)和回放工具共用
+
+INCLUDEPATH += $$PWD/../inc
+
+SOURCES += \
+    $$PWD/../src/answerstore.cpp \
+    $$PWD/../src/ruleexpression.cpp \
+    $$PWD/../src/globalrule.cpp \
+    $$PWD/../src/ruleengine.cpp \
+    $$PWD/../src/surveymodel.cpp \
+    $$PWD/../src/surveyengine.cpp \
+    $$PWD/../src/uploadjobtable.cpp \
+    $$PWD/../src/requestbody.cpp
+
+HEADERS += \
+    $$PWD/../inc/answerstore.h \
+    $$PWD/../inc/ruleexpression.h \
+    $$PWD/../inc/globalrule.h \
+    $$PWD/../inc/ruleengine.h \
+    $$PWD/../inc/surveymodel.h \
+    $$PWD/../inc/surveyengine.h \
+    $$PWD/../inc/uploadjobtable.h \
+    $$PWD/../inc/requestbody.h
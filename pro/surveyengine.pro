@@ -0,0 +1,10 @@
+# 不依赖界面的问卷引擎静态库
+QT = core
+
+CONFIG += c++17 staticlib
+
+TARGET = surveyengine
+TEMPLATE = lib
+DESTDIR = $$OUT_PWD
+
+include(surveyengine.pri)
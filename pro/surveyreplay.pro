@@ -0,0 +1,17 @@
+# 问卷会话回放工具：把录制的作答事件交给问卷引擎，检查翻页决策并统计吞吐量
+QT = core
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = surveyreplay
+TEMPLATE = app
+
+INCLUDEPATH += ../inc
+
+SOURCES += \
+    ../tools/surveyreplay/main.cpp
+
+LIBS += -L$$OUT_PWD -lsurveyengine
+win32: PRE_TARGETDEPS += $$OUT_PWD/surveyengine.lib
+else: PRE_TARGETDEPS += $$OUT_PWD/libsurveyengine.a
@@ -0,0 +1,12 @@
+# 桌面端工具：问卷引擎静态库、会话回放工具、表单性能测试和网络逻辑验证工具
+# qmake surveytools.pro && make
+TEMPLATE = subdirs
+
+SUBDIRS = surveyengine surveyreplay surveybench uploadresume serverfailover
+
+surveyengine.file = surveyengine.pro
+surveyreplay.file = surveyreplay.pro
+surveyreplay.depends = surveyengine
+surveybench.file = surveybench.pro
+uploadresume.file = uploadresume.pro
+serverfailover.file = serverfailover.pro
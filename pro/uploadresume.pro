@@ -0,0 +1,22 @@
+# 分片断点续传验证工具：用本地替身服务器检查ChunkedUploader的续传和回退逻辑
+QT = core network widgets
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = uploadresume
+TEMPLATE = app
+
+INCLUDEPATH += ../inc ../tools/standin
+
+SOURCES += \
+    ../tools/uploadresume/main.cpp \
+    ../tools/standin/standinserver.cpp \
+    ../src/chunkeduploader.cpp \
+    ../src/logfilemanager.cpp
+
+HEADERS += \
+    ../tools/standin/standinserver.h \
+    ../inc/chunkeduploader.h \
+    ../inc/logfilemanager.h \
+    ../inc/functionlogger.h
@@ -0,0 +1,67 @@
+#include "answerstore.h"
+
+SurveyAnswerStore::SurveyAnswerStore(QObject *parent) : QObject(parent)
+{
+}
+
+bool SurveyAnswerStore::setAnswer(const QString& questionId, const QJsonObject& answer)
+{
+    if (questionId.isEmpty()) {
+        return false;
+    }
+
+    if (answer.isEmpty()) {
+        if (!m_answers.contains(questionId)) {
+            return false;
+        }
+        removeAnswer(questionId);
+        return true;
+    }
+
+    auto it = m_answers.find(questionId);
+    if (it != m_answers.end() && it.value() == answer) {
+        return false; // 答案未变化，不触发后续计算
+    }
+
+    m_answers.insert(questionId, answer);
+    m_snapshot.insert(questionId, answer);
+    ++m_revision;
+    emit answerChanged(questionId);
+    return true;
+}
+
+void SurveyAnswerStore::removeAnswer(const QString& questionId)
+{
+    if (m_answers.remove(questionId) == 0) {
+        return;
+    }
+    m_snapshot.remove(questionId);
+    ++m_revision;
+    emit answerChanged(questionId);
+}
+
+void SurveyAnswerStore::clear()
+{
+    const QStringList ids = m_answers.keys();
+    m_answers.clear();
+    m_snapshot = QJsonObject();
+    ++m_revision;
+    for (const QString& id : ids) {
+        emit answerChanged(id);
+    }
+}
+
+QJsonObject SurveyAnswerStore::answer(const QString& questionId) const
+{
+    return m_answers.value(questionId);
+}
+
+bool SurveyAnswerStore::hasAnswer(const QString& questionId) const
+{
+    return m_answers.contains(questionId);
+}
+
+QStringList SurveyAnswerStore::answeredQuestions() const
+{
+    return m_answers.keys();
+}
@@ -0,0 +1,109 @@
+#include "authsession.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QDateTime>
+#include <QDebug>
+
+// 离过期不到这个时间的令牌不再使用，避免刚恢复就被服务器拒绝
+static const qint64 ExpiryMarginMs = 5 * 60 * 1000;
+
+AuthSession::AuthSession(const QString& filePath)
+    : m_filePath(filePath)
+{
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+}
+
+bool AuthSession::load()
+{
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QJsonObject obj = QJsonDocument::fromJson(file.readAll()).object();
+    m_token = obj["token"].toString();
+    m_expiresAt = obj["expiresAt"].toVariant().toLongLong();
+    m_user = obj["user"].toObject();
+    m_projects = obj["projects"].toArray();
+
+    if (!isValid()) {
+        qDebug() << "保存的登录会话已过期";
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool AuthSession::isValid() const
+{
+    return !m_token.isEmpty() && QDateTime::currentMSecsSinceEpoch() + ExpiryMarginMs < m_expiresAt;
+}
+
+void AuthSession::start(const QString& token, qint64 defaultTtlSecs)
+{
+    qint64 expiry = tokenExpiry(token);
+    m_token = token;
+    m_expiresAt = expiry > 0 ? expiry * 1000 : QDateTime::currentMSecsSinceEpoch() + defaultTtlSecs * 1000;
+    // 换了账号时不能沿用上一个用户的信息和项目
+    m_user = QJsonObject();
+    m_projects = QJsonArray();
+    save();
+}
+
+void AuthSession::setUser(const QJsonObject& user)
+{
+    if (m_token.isEmpty()) {
+        return;
+    }
+    m_user = user;
+    save();
+}
+
+void AuthSession::setProjects(const QJsonArray& projects)
+{
+    if (m_token.isEmpty()) {
+        return;
+    }
+    m_projects = projects;
+    save();
+}
+
+void AuthSession::clear()
+{
+    m_token.clear();
+    m_expiresAt = 0;
+    m_user = QJsonObject();
+    m_projects = QJsonArray();
+    QFile::remove(m_filePath);
+}
+
+qint64 AuthSession::tokenExpiry(const QString& token)
+{
+    // header.payload.signature，载荷是base64url编码的JSON
+    QStringList parts = token.split('.');
+    if (parts.size() != 3) {
+        return 0;
+    }
+    QByteArray payload = QByteArray::fromBase64(parts[1].toLatin1(),
+                                                QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals);
+    return QJsonDocument::fromJson(payload).object()["exp"].toVariant().toLongLong();
+}
+
+bool AuthSession::save() const
+{
+    QJsonObject obj{
+        {"token", m_token},
+        {"expiresAt", m_expiresAt},
+        {"user", m_user},
+        {"projects", m_projects}
+    };
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "无法保存登录会话:" << file.fileName() << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
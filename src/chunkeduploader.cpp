@@ -0,0 +1,319 @@
+#include "chunkeduploader.h"
+#include "functionlogger.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDir>
+#include <QUrlQuery>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+
+// 分片上传请求的阶段和所属会话
+static const QNetworkRequest::Attribute ChunkStageAttribute = QNetworkRequest::Attribute(QNetworkRequest::User + 10);
+static const QNetworkRequest::Attribute ChunkKeyAttribute = QNetworkRequest::Attribute(QNetworkRequest::User + 11);
+static const QNetworkRequest::Attribute ChunkIndexAttribute = QNetworkRequest::Attribute(QNetworkRequest::User + 12);
+
+// 本地进度保留时间，超过后服务器端的分片大概率已被清理
+static const qint64 ProgressExpireMs = 7LL * 24 * 3600 * 1000;
+
+ChunkedUploader::ChunkedUploader(QNetworkAccessManager *networkManager, const QString& progressFile, QObject *parent)
+    : QObject(parent)
+    , m_networkManager(networkManager)
+    , m_progressFile(progressFile)
+{
+    QDir().mkpath(QFileInfo(m_progressFile).absolutePath());
+    loadProgress();
+}
+
+bool ChunkedUploader::upload(const QString& projectId, const QString& questionId, const QString& filePath,
+                             const QVariant& context)
+{
+    FUNCTION_LOG();
+    QFileInfo fileInfo(filePath);
+    QFile file(filePath);
+    if (!fileInfo.isFile() || !file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // 同一个文件（路径、大小、修改时间不变）对应同一份上传进度
+    QString identity = QString("%1|%2|%3").arg(fileInfo.absoluteFilePath()).arg(fileInfo.size())
+                           .arg(fileInfo.lastModified().toMSecsSinceEpoch());
+    QString key = QCryptographicHash::hash(identity.toUtf8(), QCryptographicHash::Sha1).toHex();
+    if (m_sessions.contains(key)) {
+        // 文件正在分片上传，忽略重复请求
+        return true;
+    }
+
+    Session session;
+    session.key = key;
+    session.projectId = projectId;
+    session.questionId = questionId;
+    session.filePath = fileInfo.absoluteFilePath();
+    session.fileName = fileInfo.fileName();
+    session.size = fileInfo.size();
+    session.chunkSize = m_chunkSize;
+    session.context = context;
+
+    QCryptographicHash md5(QCryptographicHash::Md5);
+    md5.addData(&file);
+    session.md5 = md5.result().toHex();
+
+    // 恢复上次中断时已确认的分片
+    QJsonObject saved = m_progress[key].toObject();
+    qint64 savedChunkSize = saved["chunkSize"].toVariant().toLongLong();
+    if (savedChunkSize > 0) {
+        session.chunkSize = savedChunkSize;
+        session.uploadId = saved["uploadId"].toString();
+    }
+    session.chunkCount = int((session.size + session.chunkSize - 1) / session.chunkSize);
+    if (savedChunkSize > 0) {
+        setReceived(session, saved["received"].toArray());
+    }
+
+    m_sessions.insert(key, session);
+    sendInit(m_sessions[key]);
+    return true;
+}
+
+bool ChunkedUploader::cancel(const QString& filePath)
+{
+    QString absolutePath = QFileInfo(filePath).absoluteFilePath();
+    QPointer<QNetworkReply> reply;
+    for (const Session& session : std::as_const(m_sessions)) {
+        if (session.filePath == absolutePath) {
+            reply = session.reply;
+            break;
+        }
+    }
+    if (!reply) {
+        return false;
+    }
+    // 中止时同步触发onReplyFinished，按失败处理并删除会话；
+    // 标记为主动中止，与传输超时区分（见RetryController::abortReply）
+    reply->setProperty("abortedByClient", true);
+    reply->abort();
+    return true;
+}
+
+QNetworkRequest ChunkedUploader::createRequest(const QString& endpoint, Stage stage, const QString& key) const
+{
+    QNetworkRequest request(QUrl(m_baseUrl + endpoint));
+    if (!m_authToken.isEmpty()) {
+        request.setRawHeader("Authorization", QString("Bearer %1").arg(m_authToken).toUtf8());
+    }
+    request.setAttribute(ChunkStageAttribute, int(stage));
+    request.setAttribute(ChunkKeyAttribute, key);
+    return request;
+}
+
+void ChunkedUploader::sendInit(Session& session)
+{
+    QJsonObject body;
+    body["projectId"] = session.projectId;
+    body["questionId"] = session.questionId;
+    body["fileName"] = session.fileName;
+    body["size"] = session.size;
+    body["chunkSize"] = session.chunkSize;
+    body["chunkCount"] = session.chunkCount;
+    body["md5"] = session.md5;
+    body["uploadId"] = session.uploadId; // 为空时由服务器分配
+
+    QNetworkRequest request = createRequest("/public/upload/chunk/init", Init, session.key);
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    session.reply = m_networkManager->post(request, QJsonDocument(body).toJson(QJsonDocument::Compact));
+    QNetworkReply *reply = session.reply;
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() { onReplyFinished(reply); });
+}
+
+void ChunkedUploader::sendNextPart(Session& session)
+{
+    int index = 0;
+    while (index < session.chunkCount && session.received.contains(index)) {
+        ++index;
+    }
+    if (index >= session.chunkCount) {
+        sendComplete(session);
+        return;
+    }
+
+    QFile file(session.filePath);
+    if (!file.open(QIODevice::ReadOnly) || file.size() != session.size || !file.seek(index * session.chunkSize)) {
+        fail(session.key, "文件已变化或无法读取", false);
+        return;
+    }
+    QByteArray chunk = file.read(session.chunkSize);
+
+    QUrlQuery query;
+    query.addQueryItem("uploadId", session.uploadId);
+    query.addQueryItem("index", QString::number(index));
+    QNetworkRequest request = createRequest("/public/upload/chunk?" + query.toString(QUrl::FullyEncoded), Part, session.key);
+    request.setAttribute(ChunkIndexAttribute, index);
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/octet-stream");
+    // 分片校验，服务器校验失败时返回错误，下次只重发这个分片
+    request.setRawHeader("Content-MD5", QCryptographicHash::hash(chunk, QCryptographicHash::Md5).toBase64());
+
+    session.reply = m_networkManager->post(request, chunk);
+    QNetworkReply *reply = session.reply;
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() { onReplyFinished(reply); });
+}
+
+void ChunkedUploader::sendComplete(Session& session)
+{
+    QNetworkRequest request = createRequest("/public/upload/chunk/complete", Complete, session.key);
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    QJsonObject body{{"uploadId", session.uploadId}, {"md5", session.md5}};
+    session.reply = m_networkManager->post(request, QJsonDocument(body).toJson(QJsonDocument::Compact));
+    QNetworkReply *reply = session.reply;
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() { onReplyFinished(reply); });
+}
+
+void ChunkedUploader::onReplyFinished(QNetworkReply *reply)
+{
+    reply->deleteLater();
+    Stage stage = Stage(reply->request().attribute(ChunkStageAttribute).toInt());
+    QString key = reply->request().attribute(ChunkKeyAttribute).toString();
+    auto it = m_sessions.find(key);
+    if (it == m_sessions.end()) {
+        return;
+    }
+    Session& session = it.value();
+
+    int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (reply->error() != QNetworkReply::NoError) {
+        // 初始化时服务器返回了任何错误（404、401/403等）都说明分片接口不可用，改用整文件上传；
+        // 没有收到响应（网络中断、取消）时按普通失败处理
+        fail(key, reply->errorString(), stage == Init && httpStatus > 0);
+        return;
+    }
+
+    QJsonObject jsonObj = QJsonDocument::fromJson(reply->readAll()).object();
+    bool success = jsonObj.value("code").toInt(0) == 200 || !jsonObj.contains("error");
+    if (!success) {
+        QString errorMsg = jsonObj.contains("message") ? jsonObj["message"].toString() : QString("分片上传失败");
+        fail(key, errorMsg, stage == Init);
+        return;
+    }
+
+    switch (stage) {
+    case Init: {
+        QJsonObject data = jsonObj["data"].toObject();
+        QString uploadId = data["uploadId"].toString();
+        if (uploadId.isEmpty()) {
+            fail(key, "服务器没有返回uploadId", true);
+            return;
+        }
+        if (uploadId != session.uploadId) {
+            // 新的上传任务，之前记录的分片无效
+            session.received.clear();
+            session.uploadId = uploadId;
+        }
+        // 以服务器记录的分片为准
+        if (data.contains("received")) {
+            setReceived(session, data["received"].toArray());
+        }
+        saveProgress();
+        emit progress(session.context, confirmedBytes(session), session.size);
+        sendNextPart(session);
+        break;
+    }
+    case Part:
+        session.received.insert(reply->request().attribute(ChunkIndexAttribute).toInt());
+        saveProgress();
+        emit progress(session.context, confirmedBytes(session), session.size);
+        sendNextPart(session);
+        break;
+    case Complete: {
+        QVariant context = session.context;
+        m_sessions.erase(it);
+        m_progress.remove(key);
+        saveProgress();
+        emit finished(context, jsonObj);
+        break;
+    }
+    }
+}
+
+void ChunkedUploader::fail(const QString& key, const QString& error, bool unsupported)
+{
+    auto it = m_sessions.find(key);
+    if (it == m_sessions.end()) {
+        return;
+    }
+    // 已确认的分片保留在进度文件中，下次上传同一个文件时继续
+    QVariant context = it->context;
+    qWarning() << "分片上传失败:" << it->fileName << error;
+    m_sessions.erase(it);
+    if (unsupported) {
+        // 改用整文件上传，之前记录的uploadId也可能正是被拒绝的原因
+        m_progress.remove(key);
+        saveProgress();
+    }
+    emit failed(context, error, unsupported);
+}
+
+qint64 ChunkedUploader::confirmedBytes(const Session& session) const
+{
+    qint64 bytes = 0;
+    for (int index : session.received) {
+        bytes += qMin(session.chunkSize, session.size - index * session.chunkSize);
+    }
+    return bytes;
+}
+
+void ChunkedUploader::setReceived(Session& session, const QJsonArray& received)
+{
+    session.received.clear();
+    for (const QJsonValue& value : received) {
+        int index = value.toInt(-1);
+        if (index >= 0 && index < session.chunkCount) {
+            session.received.insert(index);
+        }
+    }
+}
+
+void ChunkedUploader::loadProgress()
+{
+    QFile file(m_progressFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    m_progress = QJsonDocument::fromJson(file.readAll()).object();
+
+    // 清理过期的进度记录
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const QStringList keys = m_progress.keys();
+    for (const QString& key : keys) {
+        if (now - m_progress[key].toObject()["updatedAt"].toVariant().toLongLong() > ProgressExpireMs) {
+            m_progress.remove(key);
+        }
+    }
+}
+
+void ChunkedUploader::saveProgress()
+{
+    QJsonObject& progress = m_progress;
+    for (const Session& session : m_sessions) {
+        if (session.uploadId.isEmpty()) {
+            continue;
+        }
+        QJsonArray received;
+        for (int index : session.received) {
+            received.append(index);
+        }
+        progress[session.key] = QJsonObject{
+            {"uploadId", session.uploadId},
+            {"chunkSize", session.chunkSize},
+            {"received", received},
+            {"updatedAt", QDateTime::currentMSecsSinceEpoch()}
+        };
+    }
+
+    QSaveFile file(m_progressFile);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(progress).toJson(QJsonDocument::Compact));
+        file.commit();
+    }
+}
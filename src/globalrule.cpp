@@ -0,0 +1,104 @@
+#include "globalrule.h"
+#include "answerstore.h"
+#include "surveymodel.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+GlobalRule GlobalRule::compile(const QString& rule, const SurveyModel& model)
+{
+    GlobalRule globalRule;
+    globalRule.m_source = rule;
+
+    QJsonDocument ruleDoc = QJsonDocument::fromJson(rule.toUtf8());
+    if (!ruleDoc.isObject()) {
+        // 不是JSON，按逻辑表达式编译
+        globalRule.m_expression = RuleExpression::compile(rule);
+        globalRule.m_kind = globalRule.m_expression.isValid() ? Expression : Invalid;
+        return globalRule;
+    }
+
+    QJsonObject ruleObj = ruleDoc.object();
+    if (!ruleObj.contains("conditionItem") || !ruleObj.contains("result")) {
+        return globalRule;
+    }
+
+    globalRule.m_kind = Structured;
+    globalRule.m_logic = ruleObj["conditionLogic"].toString("AND").compare("OR", Qt::CaseInsensitive) == 0 ? Or : And;
+
+    QJsonArray conditionItems = ruleObj["conditionItem"].toArray();
+    for (int i = 0; i < conditionItems.size(); ++i) {
+        QJsonObject conditionItem = conditionItems[i].toObject();
+
+        GlobalRuleCondition condition;
+        condition.questionId = conditionItem["qId"].toString();
+        condition.type = conditionItem["condition"].toString() == "CHECKED" ? GlobalRuleCondition::Checked
+                                                                          : GlobalRuleCondition::Unknown;
+
+        QJsonArray oIds = conditionItem["oId"].toArray();
+        for (int j = 0; j < oIds.size(); ++j) {
+            condition.optionIds.append(oIds[j].toString());
+        }
+        globalRule.m_conditions.append(condition);
+    }
+
+    QJsonArray results = ruleObj["result"].toArray();
+    for (int i = 0; i < results.size(); ++i) {
+        QJsonObject result = results[i].toObject();
+
+        GlobalRuleAction action;
+        action.type = result["type"].toString() == "jump" ? GlobalRuleAction::Jump : GlobalRuleAction::Unknown;
+        action.questionId = result["qId"].toString();
+        action.questionIndex = model.visibleIndexOf(action.questionId);
+        globalRule.m_actions.append(action);
+    }
+
+    return globalRule;
+}
+
+QStringList GlobalRule::referencedQuestions() const
+{
+    if (m_kind == Expression) {
+        return m_expression.referencedQuestions();
+    }
+
+    QStringList ids;
+    for (const GlobalRuleCondition& condition : m_conditions) {
+        if (!ids.contains(condition.questionId)) {
+            ids.append(condition.questionId);
+        }
+    }
+    return ids;
+}
+
+bool GlobalRule::conditionsMet(const SurveyAnswerStore& answers) const
+{
+    if (m_kind != Structured) {
+        return false;
+    }
+
+    bool finalResult = (m_logic == And);
+    for (const GlobalRuleCondition& condition : m_conditions) {
+        bool conditionResult = false;
+
+        if (condition.type == GlobalRuleCondition::Checked) {
+            // 检查是否选中了指定的选项
+            QJsonObject questionAnswer = answers.answer(condition.questionId);
+            for (const QString& oId : condition.optionIds) {
+                if (questionAnswer.contains(oId)) {
+                    conditionResult = true;
+                    break;
+                }
+            }
+        }
+
+        // AND逻辑任一条件不满足、OR逻辑任一条件满足时可以提前退出
+        if (m_logic == And && !conditionResult) {
+            return false;
+        }
+        if (m_logic == Or && conditionResult) {
+            return true;
+        }
+    }
+    return finalResult;
+}
@@ -125,13 +125,21 @@ void MainWindow::setupUi()
     // }, Qt::QueuedConnection);
 
     connect(&nm, &NetworkManager::surveySchemaReceived, this, &MainWindow::onSurveySchemaReceived, Qt::QueuedConnection);
+    connect(&nm, &NetworkManager::submitQueued, this, &MainWindow::onSubmitQueued, Qt::QueuedConnection);
     connect(&nm, &NetworkManager::submitSuccess, this, &MainWindow::onSubmitSuccess, Qt::QueuedConnection);
+    connect(&nm, &NetworkManager::pendingSubmissionsChanged, this, &MainWindow::onPendingSubmissionsChanged, Qt::QueuedConnection);
+    connect(&nm, &NetworkManager::uploadQueueChanged, this, &MainWindow::onUploadQueueChanged, Qt::QueuedConnection);
     connect(&nm, &NetworkManager::submitFailed, this, &MainWindow::onSubmitFailed, Qt::QueuedConnection);
     connect(&nm, &NetworkManager::networkError, this, &MainWindow::onNetworkError, Qt::QueuedConnection);
+    connect(&nm, &NetworkManager::networkWarning, this, [this](const QString& message) {
+        statusBar()->showMessage(message, 5000);
+    }, Qt::QueuedConnection);
     
     // 连接仪表板相关的信号
     connect(&nm, &NetworkManager::currentUserReceived, this, &MainWindow::onLoginSuccess, Qt::QueuedConnection);
     connect(&nm, &NetworkManager::projectListReceived, this, &MainWindow::onProjectListReceived, Qt::QueuedConnection);
+    connect(&nm, &NetworkManager::sessionRestored, this, &MainWindow::onSessionRestored, Qt::QueuedConnection);
+    connect(&nm, &NetworkManager::sessionExpired, this, &MainWindow::onSessionExpired, Qt::QueuedConnection);
 
     connect(this, &MainWindow::Signallogin,&nm, &NetworkManager::login);
     connect(this, &MainWindow::SignalregisterUser,&nm, &NetworkManager::registerUser);
@@ -140,6 +148,8 @@ void MainWindow::setupUi()
     connect(this, &MainWindow::SignalSetAuth,&nm, &NetworkManager::setAuthToken);
     connect(this, &MainWindow::SignalgetProjectList, &nm, &NetworkManager::getProjectList);
     connect(this, &MainWindow::SignalgetCurrentUser, &nm, &NetworkManager::getCurrentUser);
+    connect(this, &MainWindow::SignalcancelUploads, &nm, &NetworkManager::cancelUploads);
+    connect(this, &MainWindow::SignalsetKeepAlive, &nm, &NetworkManager::setKeepAlive);
 
     thread->start();
 
@@ -164,6 +174,8 @@ void MainWindow::setupConnections()
 void MainWindow::showLoginDialog()
 {
     FUNCTION_LOG();
+    m_sessionExpired = false;
+    emit SignalsetKeepAlive(false);
     m_stackedWidget->addWidget(m_loginDialog);
     m_stackedWidget->setCurrentWidget(m_loginDialog);
     statusBar()->showMessage("请登录");
@@ -171,7 +183,7 @@ void MainWindow::showLoginDialog()
     emit m_loginDialog->captchaRefreshRequested();
 }
 
-void MainWindow::showDashboard()
+void MainWindow::showDashboard(bool loadProjects)
 {
     FUNCTION_LOG();
     m_stackedWidget->addWidget(m_dashboardWidget);
@@ -180,11 +192,25 @@ void MainWindow::showDashboard()
     // 设置当前用户信息
     m_dashboardWidget->setCurrentUser(m_currentUser);
     
-    // 获取项目列表
-    emit SignalgetProjectList();
+    // 获取项目列表，登录和恢复会话时网络线程已经在请求，不需要再发
+    if (loadProjects) {
+        emit SignalgetProjectList();
+    }
     statusBar()->showMessage("正在加载项目列表...");
 }
 
+void MainWindow::returnToDashboard()
+{
+    emit SignalsetKeepAlive(false);
+    if (m_sessionExpired) {
+        m_currentUser = QJsonObject();
+        showLoginDialog();
+        statusBar()->showMessage("登录已过期，请重新登录");
+        return;
+    }
+    m_stackedWidget->setCurrentWidget(m_dashboardWidget);
+}
+
 void MainWindow::onLoginRequested(const QString& username, const QString& password)
 {
     FUNCTION_LOG();
@@ -203,9 +229,41 @@ void MainWindow::onLoginSuccess(const QJsonObject& userInfo)
 {
     FUNCTION_LOG();
     m_currentUser = userInfo;
+    // 恢复会话时已经显示了仪表板，只更新用户信息
+    if (m_stackedWidget->currentWidget() != m_loginDialog) {
+        m_dashboardWidget->setCurrentUser(userInfo);
+        return;
+    }
     showDashboard();
 }
 
+void MainWindow::onSessionRestored(const QJsonObject& userInfo, const QJsonArray& projects)
+{
+    FUNCTION_LOG();
+    // 不经过登录页，先显示缓存的项目列表，网络线程已经在刷新
+    m_currentUser = userInfo;
+    showDashboard(false);
+    if (!projects.isEmpty()) {
+        m_dashboardWidget->setProjects(projects);
+        statusBar()->showMessage(QString("已显示缓存的 %1 个项目，正在刷新...").arg(projects.size()));
+    }
+}
+
+void MainWindow::onSessionExpired()
+{
+    FUNCTION_LOG();
+    LogFileManager::instance().logUserAction("Session", "Session expired");
+    // 正在填写的问卷不打断，离开问卷后再登录
+    if (m_surveyFormWidget && m_stackedWidget->currentWidget() == m_surveyFormWidget) {
+        m_sessionExpired = true;
+        statusBar()->showMessage("登录已过期，提交后需要重新登录", 5000);
+        return;
+    }
+    m_currentUser = QJsonObject();
+    showLoginDialog();
+    statusBar()->showMessage("登录已过期，请重新登录");
+}
+
 void MainWindow::onProjectListReceived(const QJsonArray& projects)
 {
     FUNCTION_LOG();
@@ -228,12 +286,15 @@ void MainWindow::onSurveySelected(const QString& surveyId, const QString& title)
     m_surveyFormWidget = new SurveyFormWidget;
     m_stackedWidget->addWidget(m_surveyFormWidget);
     m_stackedWidget->setCurrentWidget(m_surveyFormWidget);
+    // 填写期间保持与服务器的连接，上传和提交不再重新握手
+    emit SignalsetKeepAlive(true);
 
     // 连接 NetworkManager 的文件上传信号
     connect(m_surveyFormWidget, &SurveyFormWidget::submitSurvey, this, &MainWindow::onSubmitResponse);
     connect(m_surveyFormWidget, &SurveyFormWidget::UploadFile, &NetworkManager::instance(), &NetworkManager::uploadFile);
     connect(&NetworkManager::instance(), &NetworkManager::fileUploadSuccess, m_surveyFormWidget, &SurveyFormWidget::handleUploadSuccsee, Qt::QueuedConnection);
     connect(&NetworkManager::instance(), &NetworkManager::fileUploadFailed, m_surveyFormWidget, &SurveyFormWidget::handleUploadFailed, Qt::QueuedConnection);
+    connect(&NetworkManager::instance(), &NetworkManager::fileUploadProgress, m_surveyFormWidget, &SurveyFormWidget::handleUploadProgress, Qt::QueuedConnection);
     
     // 连接返回问卷列表信号
     connect(m_surveyFormWidget, &SurveyFormWidget::backToSurveyList, this, &MainWindow::onBackToSurveyList);
@@ -246,29 +307,36 @@ void MainWindow::onSurveySelected(const QString& surveyId, const QString& title)
     statusBar()->showMessage(QString("正在加载问卷: %1").arg(title));
 }
 
-void MainWindow::onSurveySchemaReceived(const QJsonObject& schema)
+void MainWindow::onSurveySchemaReceived(const SurveyModelPtr& model)
 {
     FUNCTION_LOG();
-    if (m_surveyFormWidget) {
-        m_surveyFormWidget->setSurveySchema(schema);
-        statusBar()->showMessage(QString("正在填写问卷: %1").arg(m_currentSurveyTitle));
+    // 先显示缓存再后台更新时会收到两次，之前打开的问卷晚到的结构直接忽略
+    if (!m_surveyFormWidget || !model || model->id() != m_currentSurveyId) {
+        return;
+    }
+    if (m_surveyFormWidget->hasUserEdits()) {
+        // 正在作答时不替换问卷，新的结构下一位受访者开始使用
+        statusBar()->showMessage("问卷已更新，下次填写时生效");
+        return;
     }
+    m_surveyFormWidget->setSurveyModel(model);
+    statusBar()->showMessage(QString("正在填写问卷: %1").arg(m_currentSurveyTitle));
 }
 
-void MainWindow::onSubmitResponse(const QJsonObject& data)
+void MainWindow::onSubmitResponse(const QJsonObject& data, const QJsonArray& attachments)
 {
     FUNCTION_LOG();
-    emit SignalsubmitResponse(m_currentSurveyId, data, m_surveyFormWidget->GetDiffTime());
-    statusBar()->showMessage("正在提交问卷...");
+    emit SignalsubmitResponse(m_currentSurveyId, data, attachments, m_surveyFormWidget->GetDiffTime());
+    statusBar()->showMessage("正在保存问卷...");
 }
 
-void MainWindow::onSubmitSuccess()
+void MainWindow::onSubmitQueued()
 {
     FUNCTION_LOG();
-    // 创建一个无按钮的提示对话框
+    // 问卷已写入本地提交日志，由后台发送，不需要等待服务器响应
     QMessageBox *msgBox = new QMessageBox(this);
     msgBox->setWindowTitle("提交成功");
-    msgBox->setText("问卷提交成功！");
+    msgBox->setText("问卷已保存，将自动上传到服务器！");
     msgBox->setIcon(QMessageBox::Information);
     msgBox->setStandardButtons(QMessageBox::NoButton); // 不显示任何按钮
 
@@ -281,11 +349,43 @@ void MainWindow::onSubmitSuccess()
         delete msgBox;
 
         // 返回仪表板
-        m_stackedWidget->setCurrentWidget(m_dashboardWidget);
-        statusBar()->showMessage("问卷提交成功！");
+        returnToDashboard();
+        if (m_stackedWidget->currentWidget() == m_dashboardWidget) {
+            statusBar()->showMessage("问卷已保存");
+        }
     });
+    LogFileManager::instance().logUserAction("Submit", "Submit queued");
+}
+
+void MainWindow::onSubmitSuccess()
+{
+    FUNCTION_LOG();
+    statusBar()->showMessage("问卷已上传到服务器");
     LogFileManager::instance().logUserAction("Submit", "Submit success");
+}
 
+void MainWindow::onPendingSubmissionsChanged(int count)
+{
+    m_pendingSubmissions = count;
+    updateStatusLabel();
+}
+
+void MainWindow::onUploadQueueChanged(int queued, int running)
+{
+    m_queuedUploads = queued + running;
+    updateStatusLabel();
+}
+
+void MainWindow::updateStatusLabel()
+{
+    QStringList parts;
+    if (m_pendingSubmissions > 0) {
+        parts << QString("待上传问卷: %1").arg(m_pendingSubmissions);
+    }
+    if (m_queuedUploads > 0) {
+        parts << QString("上传队列: %1").arg(m_queuedUploads);
+    }
+    m_statusLabel->setText(parts.join("  "));
 }
 
 void MainWindow::onSubmitFailed(const QString& error)
@@ -377,9 +477,13 @@ void MainWindow::keyPressEvent(QKeyEvent *event)
 void MainWindow::onBackToSurveyList()
 {
     FUNCTION_LOG();
+    // 放弃填写的问卷不再上传已选择的文件
+    emit SignalcancelUploads(m_currentSurveyId);
     // 返回问卷列表页面 (仪表板页面)
-    m_stackedWidget->setCurrentWidget(m_dashboardWidget);
-    statusBar()->showMessage("已返回问卷列表");
+    returnToDashboard();
+    if (m_stackedWidget->currentWidget() == m_dashboardWidget) {
+        statusBar()->showMessage("已返回问卷列表");
+    }
 }
 
 void MainWindow::requestInitialPermissions()
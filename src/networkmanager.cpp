@@ -2,6 +2,12 @@
 #include <QNetworkRequest>
 #include <QFileInfo>
 #include <QHttpMultiPart>
+#include <QStandardPaths>
+#include <QNetworkInformation>
+#include <QGuiApplication>
+#include "settingsmanager.h"
+#include <algorithm>
+#include <limits>
 
 
 NetworkManager& NetworkManager::instance()
@@ -12,14 +18,104 @@ NetworkManager& NetworkManager::instance()
 
 NetworkManager::NetworkManager(QObject* parent) : QObject(parent)
 {
+    qRegisterMetaType<SurveyModelPtr>("SurveyModelPtr");
+    qRegisterMetaType<UploadPriority>("UploadPriority");
     m_networkManager = new QNetworkAccessManager(this);
+    // 长时间收不到数据的请求按超时失败，交给重试策略处理
+    m_networkManager->setTransferTimeout(SettingsManager::getInstance().getValue("network/transferTimeoutMs", 30000).toInt());
     connect(m_networkManager, &QNetworkAccessManager::finished, this, &NetworkManager::onReplyFinished);
+
+    // 服务器配置: server/profiles为 配置名 -> 地址列表，server/profile为使用的配置。
+    // 有多个地址时后台探测延迟，请求发往可用且最快的一个
+    QVariantMap profiles = SettingsManager::getInstance().getValue("server/profiles").toMap();
+    QString profile = SettingsManager::getInstance().getValue("server/profile", "default").toString();
+    QStringList servers = profiles.value(profile).toStringList();
+    if (servers.isEmpty()) {
+        servers << m_baseUrl;
+    }
+    m_servers = new ServerSelector(m_networkManager, this);
+    m_servers->setServers(servers, SettingsManager::getInstance().getValue("server/lastSelected").toString());
+    m_servers->setProbeTimeout(SettingsManager::getInstance().getValue("server/probeTimeoutMs", 5000).toInt());
+    m_baseUrl = m_servers->current();
+    connect(m_servers, &ServerSelector::currentChanged, this, &NetworkManager::onServerChanged);
+    m_serverProbeTimer = new QTimer(this);
+    m_serverProbeTimer->setInterval(qMax(10000, SettingsManager::getInstance().getValue("server/probeIntervalMs", 5 * 60 * 1000).toInt()));
+    connect(m_serverProbeTimer, &QTimer::timeout, this, [this]() {
+        if (m_appActive) {
+            m_servers->probe();
+        }
+    });
     // 连接错误信号
+
+    // 提交日志保存在应用数据目录，随网络管理器一起移动到网络线程
+    QString journalPath = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/submissions.journal";
+    m_journal = new SubmissionJournal(journalPath, this);
+    connect(m_journal, &SubmissionJournal::pendingCountChanged, this, &NetworkManager::pendingSubmissionsChanged);
+    m_maxSyncConcurrency = qMax(1, SettingsManager::getInstance().getValue("network/syncConcurrency", 2).toInt());
+    // 答案请求体压缩方式，需要服务器支持Content-Encoding请求头，默认不压缩
+    m_requestEncoding = parseBodyEncoding(SettingsManager::getInstance().getValue("network/requestCompression", "none").toString());
+
+    m_syncRetryTimer = new QTimer(this);
+    m_syncRetryTimer->setSingleShot(true);
+    connect(m_syncRetryTimer, &QTimer::timeout, this, &NetworkManager::startSubmissionSync);
+
+    // 分片上传与普通请求共用连接，进度文件与提交日志放在一起
+    QString progressPath = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/upload_progress.json";
+    m_chunkedUploader = new ChunkedUploader(m_networkManager, progressPath, this);
+    m_chunkedUploader->setBaseUrl(m_baseUrl);
+    m_chunkedUploader->setChunkSize(SettingsManager::getInstance().getValue("network/uploadChunkSize", 512 * 1024).toLongLong());
+    m_chunkedUploadEnabled = SettingsManager::getInstance().getValue("network/chunkedUpload", true).toBool();
+    connect(m_chunkedUploader, &ChunkedUploader::finished, this, &NetworkManager::onChunkedUploadFinished);
+    connect(m_chunkedUploader, &ChunkedUploader::failed, this, &NetworkManager::onChunkedUploadFailed);
+    connect(m_chunkedUploader, &ChunkedUploader::progress, this, &NetworkManager::onChunkedUploadProgress);
+
+    // 上传和提交请求统一排队，限制同时占用的连接数
+    m_uploadScheduler = new UploadScheduler(this);
+    m_uploadScheduler->setMaxConcurrent(SettingsManager::getInstance().getValue("network/uploadConcurrency", 2).toInt());
+    // 答题过程中持续上传的照片最多占用一个连接，其余带宽留给答案和用户选择的文件
+    m_uploadScheduler->setPriorityLimit(UploadPriority::Photo,
+                                        SettingsManager::getInstance().getValue("network/photoUploadConcurrency", 1).toInt());
+    connect(m_uploadScheduler, &UploadScheduler::taskStarted, this, &NetworkManager::onUploadTaskStarted);
+    connect(m_uploadScheduler, &UploadScheduler::queueDepthChanged, this, &NetworkManager::uploadQueueChanged);
+
+    // 同一份问卷每个受访者都要打开一次，结构没有变化时直接使用本地缓存
+    m_schemaCache.reset(new SchemaCache(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/schemas"));
+    m_schemaCacheEnabled = SettingsManager::getInstance().getValue("network/schemaCache", true).toBool();
+
+    // 只读请求和文件上传失败后自动重试；答案请求由提交日志无限重试，这里只提供退避时间
+    RetryPolicy readPolicy{3, 1000, 15000};
+    m_retry.setPolicy("/system", readPolicy);
+    m_retry.setPolicy("/currentUser", readPolicy);
+    m_retry.setPolicy("/project/list", readPolicy);
+    m_retry.setPolicy("/public/loadProject", readPolicy);
+    m_retry.setPolicy("/public/upload", RetryPolicy{3, 2000, 60000});
+    m_retry.setPolicy("/public/saveAnswer", RetryPolicy{std::numeric_limits<int>::max(), 5000, 300000});
+    m_retry.setCircuitBreaker(SettingsManager::getInstance().getValue("network/circuitFailureThreshold", 5).toInt(),
+                              15000, 300000);
+    // 收到项目列表后在后台预取并编译已发布的问卷
+    m_schemaPrefetchBudget = SettingsManager::getInstance().getValue("network/schemaPrefetchBudget", 2 * 1024 * 1024).toLongLong();
+    m_schemaPrefetchConcurrency = qMax(1, SettingsManager::getInstance().getValue("network/schemaPrefetchConcurrency", 2).toInt());
+    m_schemaPrefetchUnmeteredOnly = SettingsManager::getInstance().getValue("network/schemaPrefetchUnmeteredOnly", false).toBool();
+
+    // 登录会话保存在应用私有目录，下次启动时跳过登录页
+    m_session.reset(new AuthSession(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/session.json"));
+    m_rememberSession = SettingsManager::getInstance().getValue("session/remember", true).toBool();
+    m_sessionTtlSecs = qint64(SettingsManager::getInstance().getValue("session/ttlHours", 24 * 7).toInt()) * 3600;
+
+    // 服务器（Tomcat默认20秒）会关闭空闲连接，保活间隔要比它短
+    m_keepAliveTimer = new QTimer(this);
+    m_keepAliveTimer->setInterval(qMax(1000, SettingsManager::getInstance().getValue("network/keepAliveIntervalMs", 15000).toInt()));
+    connect(m_keepAliveTimer, &QTimer::timeout, this, &NetworkManager::onKeepAliveTimeout);
 }
 
 void NetworkManager::setAuthToken(const QString& token)
 {
     m_authToken = token;
+    m_chunkedUploader->setAuthToken(token);
+    if (token.isEmpty()) {
+        // 退出登录
+        m_session->clear();
+    }
 }
 
 QString NetworkManager::authToken() const
@@ -29,11 +125,50 @@ QString NetworkManager::authToken() const
 
 void NetworkManager::InitManager()
 {
+    // 与下面的请求同时进行DNS解析和握手
+    warmUpConnection();
+    // 回到前台时连接多半已被系统或服务器关闭，提前重新建立；网络环境可能变了，重新探测服务器
+    // 信号排队到网络线程，状态保存在成员中，不在网络线程中读取qApp
+    connect(qApp, &QGuiApplication::applicationStateChanged, this, [this](Qt::ApplicationState state) {
+        m_appActive = (state == Qt::ApplicationActive);
+        if (m_appActive) {
+            warmUpConnection();
+            m_servers->probe();
+        }
+    });
+    if (m_servers->serverCount() > 1) {
+        m_servers->probe();
+        m_serverProbeTimer->start();
+    }
 
     // 获取RSA公钥
-    QNetworkRequest request = createRequest("/system");
-    m_networkManager->get(request);
+    requestJson("GET /system", "/system", [this]() {
+        return m_networkManager->get(createRequest("/system"));
+    }, &NetworkManager::handleSystemInfo);
 
+    // 上次的会话没有过期时直接使用令牌，用户信息和项目列表与/system同时请求，
+    // 界面先显示缓存的项目列表
+    if (m_rememberSession && m_session->load()) {
+        setAuthToken(m_session->token());
+        getCurrentUser();
+        getProjectList();
+        qDebug() << "恢复登录会话，有效期至" << QDateTime::fromMSecsSinceEpoch(m_session->expiresAt());
+        emit sessionRestored(m_session->user(), m_session->projects());
+    }
+
+    // 网络恢复时发送离线期间保存的问卷
+    if (QNetworkInformation::loadDefaultBackend()) {
+        connect(QNetworkInformation::instance(), &QNetworkInformation::reachabilityChanged, this,
+                [this](QNetworkInformation::Reachability reachability) {
+            if (reachability != QNetworkInformation::Reachability::Disconnected) {
+                startSubmissionSync();
+            }
+        });
+    }
+
+    // 恢复上次退出（或崩溃）前没有提交成功的问卷
+    m_journal->load();
+    startSubmissionSync();
 
 }
 
@@ -50,17 +185,557 @@ QNetworkRequest NetworkManager::createRequest(const QString& endpoint)
     return request;
 }
 
+void NetworkManager::expectReply(QNetworkReply* reply, const ReplyHandler& handler)
+{
+    m_replyHandlers.insert(reply, handler);
+    // 只有需要新建连接的请求会发出这个信号
+    connect(reply, &QNetworkReply::socketStartedConnecting, reply, [reply]() {
+        reply->setProperty("newConnection", true);
+    });
+}
+
+void NetworkManager::expectJson(QNetworkReply* reply, void (NetworkManager::*handler)(QNetworkReply*, QJsonObject))
+{
+    expectReply(reply, [this, handler](QNetworkReply* reply) {
+        if (reply->error() != QNetworkReply::NoError) {
+            QString errorStr = reply->errorString();
+            LogFileManager::instance().logError("NetworkError", errorStr, "Error code: " + QString::number(reply->error()));
+            qDebug()<<errorStr<<"Error code: " + QString::number(reply->error());
+            emit networkError(errorStr);
+            return;
+        }
+        (this->*handler)(reply, QJsonDocument::fromJson(reply->readAll()).object());
+    });
+}
+
+void NetworkManager::sendWithRetry(const QString& endpoint, const RequestSender& send, const ReplyHandler& handler,
+                                   int attempt)
+{
+    // 熔断期间不发送请求，handler收到nullptr
+    if (m_retry.blockedFor(endpoint) > 0) {
+        handler(nullptr);
+        return;
+    }
+    expectReply(send(), [this, endpoint, send, handler, attempt](QNetworkReply* reply) {
+        int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (reply->error() == QNetworkReply::NoError) {
+            m_retry.recordSuccess(endpoint, attempt);
+            handler(reply);
+            return;
+        }
+        // 主动中止的请求不计入失败统计
+        if (RetryController::isAbortedByClient(reply)) {
+            handler(reply);
+            return;
+        }
+        int delay = m_retry.recordFailure(endpoint, attempt, RetryController::isRetryable(reply->error(), httpStatus));
+        emit retryMetricsChanged(m_retry.metrics());
+        if (delay < 0) {
+            handler(reply);
+            return;
+        }
+        qDebug() << "请求失败，" << delay << "ms后重试:" << endpoint << reply->errorString() << "第" << attempt + 1 << "次";
+        QTimer::singleShot(delay, this, [this, endpoint, send, handler, attempt]() {
+            sendWithRetry(endpoint, send, handler, attempt + 1);
+        });
+    });
+}
+
+void NetworkManager::sendShared(const QString& key, const QString& endpoint, const RequestSender& send,
+                                const ReplyHandler& handler, const ReplyHandler& completion)
+{
+    // 相同的请求还没有完成时不再发送，等同一个响应到达后依次通知
+    auto it = m_sharedRequests.find(key);
+    if (it != m_sharedRequests.end()) {
+        if (completion) {
+            it->completions.append(completion);
+        }
+        ++m_coalescedRequests;
+        qDebug() << "合并重复请求:" << key;
+        return;
+    }
+    SharedRequest request;
+    request.handler = handler;
+    if (completion) {
+        request.completions.append(completion);
+    }
+    m_sharedRequests.insert(key, request);
+    sendWithRetry(endpoint, send, [this, key](QNetworkReply* reply) {
+        // 先移除再通知，处理函数中再次发起的请求会重新发送
+        const SharedRequest request = m_sharedRequests.take(key);
+        // 解析响应、发出信号等副作用只执行一次，之后通知每个调用方
+        if (request.handler) {
+            request.handler(reply);
+        }
+        for (const ReplyHandler& completion : request.completions) {
+            completion(reply);
+        }
+    });
+}
+
+QByteArray NetworkManager::replyBody(QNetworkReply* reply)
+{
+    // 合并的请求有多个处理函数，响应内容只能读取一次，读取后保存在响应对象上
+    QVariant body = reply->property("responseBody");
+    if (!body.isValid()) {
+        body = reply->readAll();
+        reply->setProperty("responseBody", body);
+    }
+    return body.toByteArray();
+}
+
+void NetworkManager::requestJson(const QString& key, const QString& endpoint, const RequestSender& send,
+                                 void (NetworkManager::*handler)(QNetworkReply*, QJsonObject))
+{
+    sendShared(key, endpoint, send, [this, endpoint, handler](QNetworkReply* reply) {
+        if (!reply) {
+            reportNetworkFailure(endpoint, "服务器暂时无法访问，请稍后再试");
+            return;
+        }
+        if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 401) {
+            expireSession();
+            return;
+        }
+        if (reply->error() != QNetworkReply::NoError) {
+            QString errorStr = reply->errorString();
+            LogFileManager::instance().logError("NetworkError", errorStr, "Error code: " + QString::number(reply->error()));
+            qDebug()<<errorStr<<"Error code: " + QString::number(reply->error());
+            reportNetworkFailure(endpoint, errorStr);
+            return;
+        }
+        (this->*handler)(reply, QJsonDocument::fromJson(replyBody(reply)).object());
+    });
+}
+
+void NetworkManager::reportNetworkFailure(const QString& endpoint, const QString& error)
+{
+    // 服务器不可用时只弹出一次错误，之后的失败只在状态栏提示
+    if (m_retry.isOpen(endpoint) && !m_retry.takeOpenNotice(endpoint)) {
+        emit networkWarning(error);
+        return;
+    }
+    emit networkError(error);
+}
+
+void NetworkManager::warmUpConnection()
+{
+    FUNCTION_LOG();
+    // 切换前后台等情况会连续触发，短时间内只预连接一次
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (now - m_lastWarmUpAt < 5000) {
+        return;
+    }
+    m_lastWarmUpAt = now;
+    ++m_warmUps;
+
+    QUrl url(m_baseUrl);
+    if (url.scheme() == "https") {
+        m_networkManager->connectToHostEncrypted(url.host(), url.port(443));
+    } else {
+        m_networkManager->connectToHost(url.host(), url.port(80));
+    }
+}
+
+void NetworkManager::setKeepAlive(bool enabled)
+{
+    FUNCTION_LOG();
+    if (enabled == m_keepAliveTimer->isActive()) {
+        return;
+    }
+    if (enabled) {
+        warmUpConnection();
+        m_keepAliveTimer->start();
+    } else {
+        m_keepAliveTimer->stop();
+        // 每次填写结束记录一次连接复用情况
+        reportRetryMetrics();
+    }
+}
+
+void NetworkManager::onKeepAliveTimeout()
+{
+    // 应用在后台或者刚收到过响应时不需要预连接
+    if (!m_appActive
+        || QDateTime::currentMSecsSinceEpoch() - m_lastResponseAt < m_keepAliveTimer->interval()) {
+        return;
+    }
+    // 连接仍然空闲可用时不产生网络流量；已被服务器关闭时重新建立
+    warmUpConnection();
+}
+
+void NetworkManager::recordConnectionUse(QNetworkReply* reply)
+{
+    // 主动取消的请求（如返回列表时取消上传）与服务器状态无关
+    if (RetryController::isAbortedByClient(reply)) {
+        return;
+    }
+    // 没有收到响应的请求计入服务器健康状态，当前服务器不可用时切换，之后的重试发往新的服务器
+    if (!reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).isValid()) {
+        if (RetryController::isRetryable(reply)) {
+            m_servers->reportFailure(reply->url());
+        }
+        return;
+    }
+    m_servers->reportSuccess(reply->url());
+    m_lastResponseAt = QDateTime::currentMSecsSinceEpoch();
+    if (reply->property("newConnection").toBool()) {
+        ++m_connectionsOpened;
+    } else {
+        ++m_connectionsReused;
+    }
+}
+
+void NetworkManager::onServerChanged(const QString& baseUrl)
+{
+    FUNCTION_LOG();
+    qWarning() << "切换服务器:" << m_baseUrl << "->" << baseUrl;
+    LogFileManager::instance().logError("ServerFailover", m_baseUrl + " -> " + baseUrl);
+    m_baseUrl = baseUrl;
+    m_chunkedUploader->setBaseUrl(baseUrl);
+    SettingsManager::getInstance().setValue("server/lastSelected", baseUrl);
+    // 熔断状态是按原服务器累计的
+    m_retry.resetCircuits();
+    m_lastWarmUpAt = 0;
+    warmUpConnection();
+    emit networkWarning("已切换到服务器 " + QUrl(baseUrl).host());
+    // 原服务器不可用时积压的问卷改发到新服务器
+    startSubmissionSync();
+}
+
+void NetworkManager::expireSession()
+{
+    // 同时发出的几个请求都可能返回401，只处理第一个
+    if (m_authToken.isEmpty()) {
+        return;
+    }
+    qWarning() << "登录已失效，需要重新登录";
+    LogFileManager::instance().logError("SessionExpired", "Server rejected auth token");
+    setAuthToken("");
+    emit sessionExpired();
+}
+
+void NetworkManager::reportRetryMetrics()
+{
+    QJsonObject metrics = m_retry.metrics();
+    metrics["coalescedRequests"] = qint64(m_coalescedRequests);
+    quint64 connectionUses = m_connectionsOpened + m_connectionsReused;
+    metrics["connections"] = QJsonObject{
+        {"opened", qint64(m_connectionsOpened)},
+        {"reused", qint64(m_connectionsReused)},
+        {"reuseRate", connectionUses > 0 ? double(m_connectionsReused) / connectionUses : 0.0},
+        {"warmUps", qint64(m_warmUps)}
+    };
+    metrics["servers"] = m_servers->metrics();
+    LogFileManager::instance().logNetworkResponse("retryMetrics", 0, metrics);
+    emit retryMetricsChanged(metrics);
+}
+
+
+
+
+void NetworkManager::uploadFile(quint64 requestId, const QString& projectId, const QString& questionId,
+                                const QString& filePath, UploadPriority priority)
+{
+    FUNCTION_LOG();
+    // 按优先级排队，由调度器控制同时上传的数量
+    QVariantMap task{
+        {"kind", "file"},
+        {"requestId", requestId},
+        {"projectId", projectId},
+        {"questionId", questionId},
+        {"path", filePath}
+    };
+    m_uploadRequests.insert(requestId, m_uploadScheduler->enqueue(priority, task));
+}
+
+void NetworkManager::cancelUpload(quint64 requestId)
+{
+    FUNCTION_LOG();
+    auto it = m_uploadRequests.constFind(requestId);
+    if (it != m_uploadRequests.constEnd()) {
+        cancelUploadTask(it.value());
+    }
+}
 
+void NetworkManager::cancelUploads(const QString& projectId)
+{
+    FUNCTION_LOG();
+    const QList<quint64> taskIds = m_uploadRequests.values();
+    for (quint64 taskId : taskIds) {
+        if (m_uploadScheduler->task(taskId)["projectId"].toString() == projectId) {
+            cancelUploadTask(taskId);
+        }
+    }
+}
 
+void NetworkManager::cancelUploadTask(quint64 taskId)
+{
+    // 已归入提交日志的上传不取消
+    if (m_adoptedUploads.contains(taskId)) {
+        return;
+    }
+    QVariantMap task = m_uploadScheduler->task(taskId);
+    if (m_uploadScheduler->cancel(taskId)) {
+        m_uploadRequests.remove(task["requestId"].toULongLong());
+        return;
+    }
+    // 正在发送的请求中止后按失败结束，结果不再通知表单
+    m_cancelledUploads.insert(taskId);
+    if (QPointer<QNetworkReply> reply = m_uploadReplies.value(taskId)) {
+        RetryController::abortReply(reply);
+    } else {
+        m_chunkedUploader->cancel(task["path"].toString());
+    }
+}
 
-void NetworkManager::uploadFile(const QString& projectId, const QString& questionId, const QString& filePath)
+void NetworkManager::onUploadTaskStarted(quint64 taskId, const QVariantMap& task)
 {
     FUNCTION_LOG();
+    if (task["kind"].toString() == "submit") {
+        QString submissionId = task["submissionId"].toString();
+        const PendingSubmission* submission = m_journal->entry(submissionId);
+        if (!submission) {
+            // 调度器可能还在入队过程中，下一次事件循环再结束任务
+            QTimer::singleShot(0, this, [this, taskId, submissionId]() {
+                releaseUploadTask(taskId);
+                m_syncingSubmissions.remove(submissionId);
+            });
+            return;
+        }
+        QNetworkRequest request = createRequest("/public/saveAnswer");
+        QByteArray contentEncoding;
+        QByteArray body = encodeRequestBody(submission->requestBody(),
+                                            m_requestCompressionRejected ? BodyEncoding::Identity : m_requestEncoding,
+                                            &contentEncoding);
+        if (!contentEncoding.isEmpty()) {
+            request.setRawHeader("Content-Encoding", contentEncoding);
+        }
+        QNetworkReply* reply = m_networkManager->post(request, body);
+        bool compressed = !contentEncoding.isEmpty();
+        expectReply(reply, [this, taskId, submissionId, compressed](QNetworkReply* reply) {
+            releaseUploadTask(taskId);
+            int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+            if (compressed && (httpStatus == 400 || httpStatus == 415)) {
+                // 服务器不接受压缩的请求体，本次运行改为发送原文并立即重发
+                qWarning() << "服务器不支持压缩请求体，改为不压缩:" << httpStatus;
+                m_requestCompressionRejected = true;
+                finishSubmission(submissionId, false);
+                return;
+            }
+            handleSubmissionReply(reply, submissionId, -1);
+        });
+        m_uploadReplies.insert(taskId, reply);
+        return;
+    }
+
+    QVariantMap context = task;
+    context["taskId"] = taskId;
+    if (startChunkedUpload(task["projectId"].toString(), task["questionId"].toString(), task["path"].toString(), context)) {
+        return;
+    }
+    sendMultiPartUpload(taskId, task);
+}
+
+void NetworkManager::sendMultiPartUpload(quint64 taskId, const QVariantMap& task)
+{
+    QString filePath = task["path"].toString();
+    QHttpMultiPart* multiPart = createUploadMultiPart(task["projectId"].toString(), task["questionId"].toString(), filePath);
+    if (!multiPart) {
+        // 调度器可能还在入队过程中，下一次事件循环再结束任务
+        QTimer::singleShot(0, this, [this, taskId, task, filePath]() {
+            LogFileManager::instance().logError("UploadError", "文件不存在: " + filePath);
+            releaseUploadTask(taskId);
+            if (task["kind"].toString() == "attachment") {
+                // 本地文件已不存在，跳过这个附件
+                QString submissionId = task["submissionId"].toString();
+                if (m_journal->markAttachmentUploaded(submissionId, task["index"].toInt(), QString())) {
+                    continueSubmission(submissionId);
+                } else {
+                    finishSubmission(submissionId, true);
+                }
+            } else {
+                finishFileUpload(taskId, task["requestId"].toULongLong(), false, QJsonObject(), "无法打开文件");
+            }
+        });
+        return;
+    }
+
+    QNetworkRequest request(QUrl(m_baseUrl + "/public/upload"));
+    if (!m_authToken.isEmpty()) {
+        request.setRawHeader("Authorization", QString("Bearer %1").arg(m_authToken).toUtf8());
+    }
+    QNetworkReply* reply = m_networkManager->post(request, multiPart);
+    multiPart->setParent(reply); // 随响应一起释放
+    m_uploadReplies.insert(taskId, reply);
+
+    if (task["kind"].toString() == "attachment") {
+        QString submissionId = task["submissionId"].toString();
+        int index = task["index"].toInt();
+        expectReply(reply, [this, taskId, submissionId, index](QNetworkReply* reply) {
+            releaseUploadTask(taskId);
+            handleSubmissionReply(reply, submissionId, index);
+        });
+        return;
+    }
+
+    quint64 requestId = task["requestId"].toULongLong();
+    connect(reply, &QNetworkReply::uploadProgress, this, [this, requestId](qint64 bytesSent, qint64 bytesTotal) {
+        emit fileUploadProgress(requestId, bytesSent, bytesTotal);
+    });
+    expectReply(reply, [this, taskId, requestId, task](QNetworkReply* reply) {
+        if (reply->error() != QNetworkReply::NoError) {
+            LogFileManager::instance().logError("NetworkError", reply->errorString(), "Error code: " + QString::number(reply->error()));
+            if (retryUploadLater(taskId, task, RetryController::isRetryable(reply))) {
+                return;
+            }
+            releaseUploadTask(taskId);
+            finishFileUpload(taskId, requestId, false, QJsonObject(), reply->errorString());
+        } else {
+            m_retry.recordSuccess("/public/upload", task.value("attempt").toInt());
+            releaseUploadTask(taskId);
+            finishFileUpload(taskId, requestId, true, QJsonDocument::fromJson(reply->readAll()).object(), QString());
+        }
+    });
+}
+
+bool NetworkManager::retryUploadLater(quint64 taskId, const QVariantMap& task, bool retryable)
+{
+    // 用户取消的上传不重试
+    if (m_cancelledUploads.contains(taskId)) {
+        return false;
+    }
+    int attempt = task.value("attempt").toInt();
+    int delay = m_retry.recordFailure("/public/upload", attempt, retryable);
+    emit retryMetricsChanged(m_retry.metrics());
+    if (delay < 0) {
+        return false;
+    }
+
+    // 等待期间继续占用并发名额，取消和归入提交日志的处理与正在上传时相同
+    m_uploadReplies.remove(taskId);
+    QVariantMap retryTask = task;
+    retryTask["attempt"] = attempt + 1;
+    qDebug() << "文件上传失败，" << delay << "ms后重试:" << task["path"].toString();
+    QTimer::singleShot(delay, this, [this, taskId, retryTask]() {
+        if (m_cancelledUploads.contains(taskId) || m_retry.blockedFor("/public/upload") > 0) {
+            releaseUploadTask(taskId);
+            finishFileUpload(taskId, retryTask["requestId"].toULongLong(), false, QJsonObject(), "服务器暂时无法访问，请稍后再试");
+            return;
+        }
+        onUploadTaskStarted(taskId, retryTask);
+    });
+    return true;
+}
+
+void NetworkManager::releaseUploadTask(quint64 taskId)
+{
+    m_uploadReplies.remove(taskId);
+    QString submissionId = m_uploadScheduler->task(taskId)["submissionId"].toString();
+    if (!submissionId.isEmpty() && m_submissionTasks.value(submissionId) == taskId) {
+        m_submissionTasks.remove(submissionId);
+    }
+    m_uploadScheduler->finish(taskId);
+}
+
+void NetworkManager::finishFileUpload(quint64 taskId, quint64 requestId, bool transportOk, const QJsonObject& jsonObj,
+                                      const QString& error)
+{
+    m_uploadRequests.remove(requestId);
+    if (m_cancelledUploads.remove(taskId)) {
+        return;
+    }
+
+    // 表单已提交，结果记到提交日志中
+    auto adopted = m_adoptedUploads.find(taskId);
+    if (adopted != m_adoptedUploads.end()) {
+        QPair<QString, int> attachment = adopted.value();
+        m_adoptedUploads.erase(adopted);
+        if (transportOk) {
+            bool success = jsonObj.value("code").toInt(0) == 200 || !jsonObj.contains("error");
+            finishAttachmentUpload(attachment.first, attachment.second, success, jsonObj);
+        } else {
+            // 附件仍未上传，由提交日志重新上传
+            continueSubmission(attachment.first);
+        }
+        return;
+    }
+
+    if (transportOk) {
+        handleFileUploadFinished(requestId, jsonObj);
+    } else {
+        emit fileUploadFailed(requestId, error);
+    }
+}
+
+bool NetworkManager::startChunkedUpload(const QString& projectId, const QString& questionId, const QString& filePath,
+                                        const QVariantMap& context)
+{
+    // 小文件一次就能传完，分片只会多出初始化和合并两个请求
+    if (!m_chunkedUploadEnabled || m_chunkedUnsupported || QFileInfo(filePath).size() <= m_chunkedUploader->chunkSize()) {
+        return false;
+    }
+    return m_chunkedUploader->upload(projectId, questionId, filePath, context);
+}
+
+void NetworkManager::onChunkedUploadFinished(const QVariant& context, const QJsonObject& response)
+{
+    FUNCTION_LOG();
+    QVariantMap task = context.toMap();
+    quint64 taskId = task["taskId"].toULongLong();
+    m_retry.recordSuccess("/public/upload", task.value("attempt").toInt());
+    releaseUploadTask(taskId);
+    if (task["kind"].toString() == "attachment") {
+        bool success = response.value("code").toInt(0) == 200 || !response.contains("error");
+        finishAttachmentUpload(task["submissionId"].toString(), task["index"].toInt(), success, response);
+        return;
+    }
+    finishFileUpload(taskId, task["requestId"].toULongLong(), true, response, QString());
+}
+
+void NetworkManager::onChunkedUploadProgress(const QVariant& context, qint64 bytesSent, qint64 bytesTotal)
+{
+    QVariantMap task = context.toMap();
+    if (task["kind"].toString() == "file") {
+        emit fileUploadProgress(task["requestId"].toULongLong(), bytesSent, bytesTotal);
+    }
+}
+
+void NetworkManager::onChunkedUploadFailed(const QVariant& context, const QString& error, bool unsupported)
+{
+    FUNCTION_LOG();
+    QVariantMap task = context.toMap();
+    quint64 taskId = task["taskId"].toULongLong();
+    if (unsupported) {
+        qDebug() << "服务器不支持分片上传，改用整文件上传:" << error;
+        m_chunkedUnsupported = true;
+        // 占用的并发名额不变，直接改用整文件上传
+        if (!m_cancelledUploads.contains(taskId)) {
+            sendMultiPartUpload(taskId, task);
+            return;
+        }
+    } else {
+        LogFileManager::instance().logError("UploadError", error);
+        // 分片进度已保存，重试时只补传缺失的分片
+        if (task["kind"].toString() == "file" && retryUploadLater(taskId, task, true)) {
+            return;
+        }
+    }
+
+    releaseUploadTask(taskId);
+    if (task["kind"].toString() == "attachment") {
+        // 分片进度已保存，重试时只补传缺失的分片
+        finishSubmission(task["submissionId"].toString(), true);
+        return;
+    }
+    finishFileUpload(taskId, task["requestId"].toULongLong(), false, QJsonObject(), error);
+}
+
+QHttpMultiPart* NetworkManager::createUploadMultiPart(const QString& projectId, const QString& questionId, const QString& filePath)
+{
     QFile* file = new QFile(filePath);
     if (!file->open(QIODevice::ReadOnly)) {
-        emit fileUploadFailed("无法打开文件");
         delete file;
-        return;
+        return nullptr;
     }
     
     // 创建 multipart 请求
@@ -130,25 +805,17 @@ void NetworkManager::uploadFile(const QString& projectId, const QString& questio
     publicUploadPart.setBody("true");
     multiPart->append(publicUploadPart);
     
-    // 发送请求
-    QUrl url(m_baseUrl + "/public/upload");
-    QNetworkRequest request(url);
-    
-    if (!m_authToken.isEmpty()) {
-        request.setRawHeader("Authorization", QString("Bearer %1").arg(m_authToken).toUtf8());
-    }
-    // LogFileManager::instance().logNetworkRequest("/public/upload", );
-    m_networkManager->post(request, multiPart);
+    return multiPart;
 }
 
-void NetworkManager::handleFileUploadFinished(QNetworkReply* reply, QJsonObject jsonObj)
+void NetworkManager::handleFileUploadFinished(quint64 requestId, const QJsonObject& jsonObj)
 {
     FUNCTION_LOG();
     LogFileManager::instance().logNetworkResponse("/public/upload", jsonObj.value("code").toInt(0), jsonObj);
 
     if (jsonObj.value("code").toInt(0) == 200 || !jsonObj.contains("error")) {
         // 成功上传
-        emit fileUploadSuccess(jsonObj);
+        emit fileUploadSuccess(requestId, jsonObj);
     }
     else
     {
@@ -157,7 +824,7 @@ void NetworkManager::handleFileUploadFinished(QNetworkReply* reply, QJsonObject
             errorMsg = jsonObj["message"].toString();
         }
         LogFileManager::instance().logError("UploadError", errorMsg);
-        emit networkError(errorMsg);
+        emit fileUploadFailed(requestId, errorMsg);
     }
 }
 
@@ -171,8 +838,13 @@ void NetworkManager::handleCurrentUser(QNetworkReply *reply, QJsonObject jsonObj
         if (jsonObj.contains("data") && jsonObj["data"].toObject().contains("name")) {
             m_currentUsername = jsonObj["data"].toObject()["name"].toString();
         }
+        m_session->setUser(jsonObj);
         emit currentUserReceived(jsonObj);
     }
+    else if (jsonObj.value("code").toInt(0) == 401)
+    {
+        expireSession();
+    }
     else
     {
         QString errorMsg = "Failed to Current User Info";
@@ -215,8 +887,8 @@ void NetworkManager::login(const QString& username, const QString& password)
 
     LogFileManager::instance().logNetworkRequest("/public/login", jsonData);
 
-    QByteArray postData = QJsonDocument(jsonData).toJson();
-    m_networkManager->post(request, postData);
+    QByteArray postData = QJsonDocument(jsonData).toJson(QJsonDocument::Compact);
+    expectJson(m_networkManager->post(request, postData), &NetworkManager::handleLoginResponse);
 }
 
 void NetworkManager::registerUser(const QString& username, const QString& password)
@@ -230,8 +902,8 @@ void NetworkManager::registerUser(const QString& username, const QString& passwo
 
     LogFileManager::instance().logNetworkRequest("/public/register", jsonData);
 
-    QByteArray postData = QJsonDocument(jsonData).toJson();
-    m_networkManager->post(request, postData);
+    QByteArray postData = QJsonDocument(jsonData).toJson(QJsonDocument::Compact);
+    expectJson(m_networkManager->post(request, postData), &NetworkManager::handleRegisterResponse);
 }
 
 void NetworkManager::getSurveyList(int pageSize, int curPage)
@@ -241,21 +913,112 @@ void NetworkManager::getSurveyList(int pageSize, int curPage)
 
     LogFileManager::instance().logNetworkRequest(endpoint, QJsonObject());
 
-    QNetworkRequest request = createRequest(endpoint);
-    m_networkManager->get(request);
+    requestJson("GET " + endpoint, "/project/list", [this, endpoint]() {
+        return m_networkManager->get(createRequest(endpoint));
+    }, &NetworkManager::handleProjectListResponse);
 }
 
 void NetworkManager::getSurveySchema(const QString& surveyId)
 {
     FUNCTION_LOG();
+    m_schemaPrefetchQueue.removeAll(surveyId);
+
+    // 项目列表中的版本与缓存一致时不再请求；版本未知时先显示缓存再后台确认，
+    // 已知缓存过期时等待新的结构，请求失败再退回缓存
+    bool renderedFromCache = false;
+    const CachedSchema *cached = m_schemaCacheEnabled ? m_schemaCache->entry(surveyId) : nullptr;
+    if (cached) {
+        if (m_schemaCache->isFresh(surveyId)) {
+            qDebug() << "使用缓存的问卷结构:" << surveyId << cached->updateAt;
+            emit surveySchemaReceived(m_schemaCache->model(surveyId));
+            return;
+        }
+        if (!m_schemaCache->isStale(surveyId)) {
+            emit surveySchemaReceived(m_schemaCache->model(surveyId));
+            renderedFromCache = true;
+        }
+    }
+
+    // 连续点击或正在预取的问卷共用同一个请求，响应只写入一次缓存
+    QString version = m_schemaCache->serverVersion(surveyId);
+    sendShared("POST /public/loadProject " + surveyId, "/public/loadProject", [this, surveyId]() {
+        return postSchemaRequest(surveyId);
+    }, [this, surveyId, version](QNetworkReply* reply) {
+        storeSchemaReply(reply, surveyId, version);
+    }, [this, surveyId, renderedFromCache](QNetworkReply* reply) {
+        handleSurveySchemaReply(reply, surveyId, renderedFromCache);
+    });
+}
+
+QNetworkReply* NetworkManager::postSchemaRequest(const QString& surveyId)
+{
     QNetworkRequest request = createRequest("/public/loadProject");
-    
+    // 有缓存时带上验证信息，服务器支持时返回304
+    const CachedSchema *cached = m_schemaCacheEnabled ? m_schemaCache->entry(surveyId) : nullptr;
+    if (cached && !cached->etag.isEmpty()) {
+        request.setRawHeader("If-None-Match", cached->etag.toUtf8());
+    }
+    if (cached && !cached->lastModified.isEmpty()) {
+        request.setRawHeader("If-Modified-Since", cached->lastModified.toUtf8());
+    }
+
     QJsonObject requestData;
     requestData["id"] = surveyId;
-    
-    QByteArray postData = QJsonDocument(requestData).toJson();
-    m_networkManager->post(request, postData);
+
+    QByteArray postData = QJsonDocument(requestData).toJson(QJsonDocument::Compact);
+    return m_networkManager->post(request, postData);
 }
+
+void NetworkManager::prefetchSchemas(const QJsonArray& projects)
+{
+    FUNCTION_LOG();
+    if (!m_schemaCacheEnabled || m_schemaPrefetchBudget <= 0) {
+        return;
+    }
+    // 按流量计费的网络上是否预取由用户设置决定
+    if (m_schemaPrefetchUnmeteredOnly && QNetworkInformation::instance()
+        && QNetworkInformation::instance()->isMetered()) {
+        qDebug() << "按流量计费的网络，跳过问卷预取";
+        return;
+    }
+
+    // 每次刷新列表重新计算流量预算，只预取已发布且缓存不是最新的问卷
+    m_schemaPrefetchQueue.clear();
+    m_schemaPrefetchBytes = 0;
+    for (const QJsonValue& value : projects) {
+        QJsonObject project = value.toObject();
+        QString projectId = project["id"].toString();
+        if (project["status"].toInt() != 1 || projectId.isEmpty() || m_schemaPrefetching.contains(projectId)
+            || m_schemaCache->isFresh(projectId)) {
+            continue;
+        }
+        m_schemaPrefetchQueue.append(projectId);
+    }
+    startSchemaPrefetch();
+}
+
+void NetworkManager::startSchemaPrefetch()
+{
+    while (!m_schemaPrefetchQueue.isEmpty() && m_schemaPrefetching.size() < m_schemaPrefetchConcurrency) {
+        if (m_schemaPrefetchBytes >= m_schemaPrefetchBudget) {
+            qDebug() << "问卷预取已达到流量上限:" << m_schemaPrefetchBytes << "剩余" << m_schemaPrefetchQueue.size();
+            m_schemaPrefetchQueue.clear();
+            return;
+        }
+        QString surveyId = m_schemaPrefetchQueue.takeFirst();
+        QString version = m_schemaCache->serverVersion(surveyId);
+        m_schemaPrefetching.insert(surveyId);
+        // 用户在预取过程中打开这份问卷时合并到同一个请求
+        sendShared("POST /public/loadProject " + surveyId, "/public/loadProject", [this, surveyId]() {
+            return postSchemaRequest(surveyId);
+        }, [this, surveyId, version](QNetworkReply* reply) {
+            storeSchemaReply(reply, surveyId, version);
+        }, [this, surveyId](QNetworkReply* reply) {
+            handleSchemaPrefetchReply(reply, surveyId);
+        });
+    }
+}
+
 QString NetworkManager::getLocalIPv4Address() {
     // 遍历所有网络接口
     foreach (QNetworkInterface interface, QNetworkInterface::allInterfaces()) {
@@ -280,11 +1043,9 @@ QString NetworkManager::getLocalIPv4Address() {
     return QHostAddress(QHostAddress::LocalHost).toString();
 }
 
-void NetworkManager::submitResponse(const QString& surveyId, const QJsonObject& data, qint64 diffTime)
+void NetworkManager::submitResponse(const QString& surveyId, const QJsonObject& data, const QJsonArray& attachments, qint64 diffTime)
 {
     FUNCTION_LOG();
-    QNetworkRequest request = createRequest("/public/saveAnswer");
-    
     QJsonObject requestData;
     requestData["projectId"] = surveyId;
     requestData["answer"] = data;
@@ -321,22 +1082,218 @@ void NetworkManager::submitResponse(const QString& surveyId, const QJsonObject&
 
     LogFileManager::instance().logNetworkRequest("/public/saveAnswer", requestData);
 
-    QByteArray postData = QJsonDocument(requestData).toJson();
-    m_networkManager->post(request, postData);
+    // 先写入本地提交日志再发送，断网或崩溃都不会丢失答案
+    QString submissionId = m_journal->append(surveyId, requestData, attachments);
+    if (submissionId.isEmpty()) {
+        LogFileManager::instance().logError("SubmitError", "写入提交日志失败");
+        emit submitFailed("无法保存问卷到本地，请检查存储空间后重试");
+        return;
+    }
+    adoptFormUploads(submissionId, attachments);
+    emit submitQueued(submissionId);
+    startSubmissionSync();
+}
+
+bool NetworkManager::isOffline() const
+{
+    QNetworkInformation* info = QNetworkInformation::instance();
+    return info && info->reachability() == QNetworkInformation::Reachability::Disconnected;
+}
+
+void NetworkManager::startSubmissionSync()
+{
+    FUNCTION_LOG();
+    if (isOffline()) {
+        qDebug() << "网络不可用，待提交问卷:" << m_journal->pendingCount();
+        return;
+    }
+
+    const QStringList pendingIds = m_journal->pendingIds();
+    for (const QString& submissionId : pendingIds) {
+        if (m_syncingSubmissions.size() >= m_maxSyncConcurrency) {
+            break;
+        }
+        if (m_syncingSubmissions.contains(submissionId)) {
+            continue;
+        }
+        m_syncingSubmissions.insert(submissionId);
+        sendSubmission(submissionId);
+    }
+}
+
+void NetworkManager::sendSubmission(const QString& submissionId)
+{
+    FUNCTION_LOG();
+    const PendingSubmission* submission = m_journal->entry(submissionId);
+    if (!submission) {
+        m_syncingSubmissions.remove(submissionId);
+        return;
+    }
+    // 同一份问卷同时只有一个请求在排队或发送
+    if (m_submissionTasks.contains(submissionId)) {
+        return;
+    }
+
+    // 先补传离线时没有上传成功的附件，全部完成后再提交答案
+    const QList<int> pendingAttachments = submission->pendingAttachments();
+    for (int index : pendingAttachments) {
+        if (isAttachmentAdopted(submissionId, index)) {
+            continue;
+        }
+        QJsonObject attachment = submission->attachments[index].toObject();
+        QVariantMap task{
+            {"kind", "attachment"},
+            {"submissionId", submissionId},
+            {"index", index},
+            {"projectId", submission->projectId},
+            {"questionId", attachment["field"].toString()},
+            {"path", attachment["path"].toString()}
+        };
+        m_submissionTasks.insert(submissionId, m_uploadScheduler->enqueue(UploadPriority::UserFile, task));
+        return;
+    }
+
+    // 表单中正在上传的附件完成后再继续
+    for (const QPair<QString, int>& adopted : std::as_const(m_adoptedUploads)) {
+        if (adopted.first == submissionId) {
+            return;
+        }
+    }
+
+    QVariantMap task{{"kind", "submit"}, {"submissionId", submissionId}};
+    m_submissionTasks.insert(submissionId, m_uploadScheduler->enqueue(UploadPriority::Answer, task));
+}
+
+void NetworkManager::continueSubmission(const QString& submissionId)
+{
+    if (m_syncingSubmissions.contains(submissionId) && !m_submissionTasks.contains(submissionId)) {
+        sendSubmission(submissionId);
+    }
+}
+
+bool NetworkManager::isAttachmentAdopted(const QString& submissionId, int index) const
+{
+    return std::find(m_adoptedUploads.cbegin(), m_adoptedUploads.cend(), qMakePair(submissionId, index))
+           != m_adoptedUploads.cend();
+}
+
+void NetworkManager::adoptFormUploads(const QString& submissionId, const QJsonArray& attachments)
+{
+    // 表单中还没有上传完的文件归入提交日志：排队中的直接取消由日志补传，
+    // 正在发送的等它完成后把结果记到日志中，避免重复上传
+    for (int index = 0; index < attachments.size(); ++index) {
+        quint64 requestId = attachments[index].toObject()["requestId"].toVariant().toULongLong();
+        auto it = m_uploadRequests.find(requestId);
+        if (it == m_uploadRequests.end()) {
+            continue;
+        }
+        quint64 taskId = it.value();
+        if (m_cancelledUploads.contains(taskId)) {
+            continue;
+        }
+        if (m_uploadScheduler->cancel(taskId)) {
+            m_uploadRequests.erase(it);
+        } else {
+            m_adoptedUploads.insert(taskId, qMakePair(submissionId, index));
+        }
+    }
+}
+
+void NetworkManager::finishSubmission(const QString& submissionId, bool retryLater)
+{
+    m_syncingSubmissions.remove(submissionId);
+    if (retryLater) {
+        // 网络问题，其余问卷大概率也会失败，等待网络恢复或按退避时间重试，
+        // 随机抖动避免网络恢复后所有设备同时重发
+        if (!m_syncRetryTimer->isActive()) {
+            int delay = m_retry.recordFailure("/public/saveAnswer", m_syncRetryAttempt, true);
+            if (delay < 0) {
+                delay = m_retry.policy("/public/saveAnswer").maxDelayMs;
+            }
+            ++m_syncRetryAttempt;
+            m_syncRetryTimer->start(delay);
+            emit retryMetricsChanged(m_retry.metrics());
+        }
+        return;
+    }
+    startSubmissionSync();
+}
+
+void NetworkManager::handleSubmissionReply(QNetworkReply* reply, const QString& submissionId, int attachmentIndex)
+{
+    FUNCTION_LOG();
+    int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (reply->error() != QNetworkReply::NoError) {
+        LogFileManager::instance().logError("SubmitSyncError", reply->errorString(),
+                                            "Error code: " + QString::number(reply->error()));
+        // 网络问题、可重试的状态码和登录失效稍后重发；服务器明确拒绝的请求重发也不会成功，按拒绝处理
+        if (httpStatus == 0 || httpStatus == 401 || RetryController::isRetryable(reply)) {
+            finishSubmission(submissionId, true);
+            return;
+        }
+    }
+
+    QJsonObject jsonObj = QJsonDocument::fromJson(reply->readAll()).object();
+    bool success = reply->error() == QNetworkReply::NoError
+                   && (jsonObj.value("code").toInt(0) == 200 || !jsonObj.contains("error"));
+    QString errorMsg = jsonObj.contains("message") ? jsonObj["message"].toString() : jsonObj["errorMsg"].toString();
+    if (!success && errorMsg.isEmpty() && reply->error() != QNetworkReply::NoError) {
+        errorMsg = QString("HTTP %1: %2").arg(httpStatus).arg(reply->errorString());
+    }
+
+    if (attachmentIndex >= 0) {
+        finishAttachmentUpload(submissionId, attachmentIndex, success, jsonObj);
+        return;
+    }
+
+    LogFileManager::instance().logNetworkResponse("/public/saveAnswer", jsonObj.value("code").toInt(0), jsonObj);
+    if (success) {
+        m_journal->acknowledge(submissionId);
+        m_retry.recordSuccess("/public/saveAnswer", m_syncRetryAttempt);
+        m_syncRetryAttempt = 0;
+        emit submitSuccess();
+    } else {
+        if (errorMsg.isEmpty()) {
+            errorMsg = "Failed to submit survey";
+        }
+        LogFileManager::instance().logError("SubmitError", errorMsg);
+        // 保留在提交日志中，但不再自动重试
+        m_journal->markRejected(submissionId, errorMsg);
+        emit submitFailed(errorMsg);
+    }
+    finishSubmission(submissionId, false);
+}
+
+void NetworkManager::finishAttachmentUpload(const QString& submissionId, int index, bool success, const QJsonObject& jsonObj)
+{
+    LogFileManager::instance().logNetworkResponse("/public/upload", jsonObj.value("code").toInt(0), jsonObj);
+    // 服务器拒绝的附件不再重传，避免整份问卷一直无法提交
+    QString fileId = success ? jsonObj["data"].toObject()["id"].toString() : QString();
+    if (!success) {
+        LogFileManager::instance().logError("UploadError", jsonObj.contains("message") ? jsonObj["message"].toString()
+                                                                                       : jsonObj["errorMsg"].toString());
+    }
+    if (!m_journal->markAttachmentUploaded(submissionId, index, fileId)) {
+        finishSubmission(submissionId, true);
+        return;
+    }
+    continueSubmission(submissionId);
 }
 
 void NetworkManager::getCurrentUser()
 {
     FUNCTION_LOG();
-    QNetworkRequest request = createRequest("/currentUser");
-    m_networkManager->get(request);
+    requestJson("GET /currentUser", "/currentUser", [this]() {
+        return m_networkManager->get(createRequest("/currentUser"));
+    }, &NetworkManager::handleCurrentUser);
 }
 
 void NetworkManager::getProjectList()
 {
     FUNCTION_LOG();
-    QNetworkRequest request = createRequest("/project/list");
-    m_networkManager->get(request);
+    requestJson("GET /project/list", "/project/list", [this]() {
+        return m_networkManager->get(createRequest("/project/list"));
+    }, &NetworkManager::handleProjectListResponse);
 }
 
 void NetworkManager::onRefreshCaptcha()
@@ -348,39 +1305,14 @@ void NetworkManager::onRefreshCaptcha()
 void NetworkManager::onReplyFinished(QNetworkReply* reply)
 {
     FUNCTION_LOG();
-    if (reply->error() != QNetworkReply::NoError) {
-        QString errorStr = reply->errorString();
-        LogFileManager::instance().logError("NetworkError", errorStr, "Error code: " + QString::number(reply->error()));
-        qDebug()<<errorStr<<"Error code: " + QString::number(reply->error());
-        emit networkError(reply->errorString());
-        reply->deleteLater();
-        return;
-    }
-
-    QByteArray responseData = reply->readAll();
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData);
-    QJsonObject jsonObj = jsonDoc.object();
-
-    QString url = reply->url().toString();
-    if(url.contains("/system")) {
-        handleSystemInfo(reply, jsonObj);
-    }else if (url.contains("/public/login")) {
-        handleLoginResponse(reply, jsonObj);
-    } else if (url.contains("/currentUser")) {
-        handleCurrentUser(reply, jsonObj);
-    } else if (url.contains("/public/register")) {
-        handleRegisterResponse(reply, jsonObj);
-    } else if (url.contains("/project/list")) {
-        handleProjectListResponse(jsonObj);
-    } else if (url.contains("/public/loadProject")) {
-        handleSurveySchemaResponse(jsonObj);
-    } else if (url.contains("/public/saveAnswer")) {
-        handleSubmitResponse(reply, jsonObj);
-    } else if (url.contains("/public/upload")) {
-        handleFileUploadFinished(reply, jsonObj);
+    // 每个请求发出时登记了处理函数，按响应对象直接找到，不再按URL判断请求类型。
+    // 没有登记的响应（如分片上传）由发出请求的对象自己处理和释放
+    ReplyHandler handler = m_replyHandlers.take(reply);
+    if (!handler) {
+        return;
     }
-
-
+    recordConnectionUse(reply);
+    handler(reply);
     reply->deleteLater();
 }
 
@@ -396,10 +1328,14 @@ void NetworkManager::handleLoginResponse(QNetworkReply* reply, QJsonObject jsonO
             token = token.mid(7);
         }
         setAuthToken(token);
+        if (m_rememberSession) {
+            m_session->start(token, m_sessionTtlSecs);
+        }
         // emit loginSuccess(jsonObj);
 
-        // 获取当前用户权限
+        // 获取当前用户权限，同时请求项目列表，不等用户信息返回
         getCurrentUser();
+        getProjectList();
 
     } else {
         QString errorMsg = "Login failed";
@@ -421,13 +1357,22 @@ void NetworkManager::handleRegisterResponse(QNetworkReply* reply, QJsonObject js
 }
 
 
-void NetworkManager::handleProjectListResponse(QJsonObject jsonObj)
+void NetworkManager::handleProjectListResponse(QNetworkReply* reply, QJsonObject jsonObj)
 {
     FUNCTION_LOG();
     LogFileManager::instance().logNetworkResponse("/project/list", jsonObj.value("code").toInt(0), jsonObj);
     if (jsonObj.value("code").toInt(0) == 200 || !jsonObj.contains("error")) {
         QJsonArray list = jsonObj["data"].toObject()["list"].toArray();
+        // 记录每个项目的更新时间，打开问卷时据此判断缓存是否有效
+        for (const QJsonValue& value : std::as_const(list)) {
+            QJsonObject project = value.toObject();
+            m_schemaCache->setServerVersion(project["id"].toString(), project["updateAt"].toString());
+        }
+        m_session->setProjects(list);
         emit projectListReceived(list);
+        prefetchSchemas(list);
+    } else if (jsonObj.value("code").toInt(0) == 401) {
+        expireSession();
     } else {
         QString errorMsg = "Failed to get project list";
         if (jsonObj.contains("message")) {
@@ -437,38 +1382,94 @@ void NetworkManager::handleProjectListResponse(QJsonObject jsonObj)
     }
 }
 
-void NetworkManager::handleSurveySchemaResponse(QJsonObject jsonObj)
+void NetworkManager::storeSchemaReply(QNetworkReply* reply, const QString& surveyId, const QString& version)
 {
     FUNCTION_LOG();
+    if (!reply) {
+        return;
+    }
+    int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (httpStatus == 304) {
+        // 服务器确认没有变化（只有带着缓存的验证信息请求时才会返回304）
+        m_schemaCache->revalidated(surveyId, version);
+        m_schemaCache->model(surveyId);
+        reply->setProperty("schemaCached", true);
+        return;
+    }
+    if (reply->error() != QNetworkReply::NoError) {
+        return;
+    }
+
+    QJsonObject jsonObj = QJsonDocument::fromJson(replyBody(reply)).object();
     LogFileManager::instance().logNetworkResponse("/public/loadProject", jsonObj.value("code").toInt(0), jsonObj);
+    // 错误响应不写入缓存
+    QJsonObject schema = jsonObj.contains("data") ? jsonObj["data"].toObject() : jsonObj;
+    if (!m_schemaCacheEnabled || schema["id"].toString() != surveyId) {
+        return;
+    }
+    bool changed = m_schemaCache->store(surveyId, schema, version,
+                                        QString::fromUtf8(reply->rawHeader("ETag")),
+                                        QString::fromUtf8(reply->rawHeader("Last-Modified")));
+    // 在网络线程中提前编译，打开问卷时直接使用
+    m_schemaCache->model(surveyId);
+    reply->setProperty("schemaCached", true);
+    reply->setProperty("schemaChanged", changed);
+}
 
-    // SurveyKing returns the full project info directly
-    // Check if the response contains data field
-    if (jsonObj.contains("data")) {
-        QJsonObject data = jsonObj["data"].toObject();
-        emit surveySchemaReceived(data);
+void NetworkManager::handleSchemaPrefetchReply(QNetworkReply* reply, const QString& surveyId)
+{
+    FUNCTION_LOG();
+    m_schemaPrefetching.remove(surveyId);
+    if (reply && reply->property("schemaCached").toBool()) {
+        if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 304) {
+            m_schemaPrefetchBytes += replyBody(reply).size();
+        }
     } else {
-        emit surveySchemaReceived(jsonObj);
+        qWarning() << "问卷预取失败:" << surveyId << (reply ? reply->errorString() : QString("服务器暂时无法访问"));
     }
-
+    startSchemaPrefetch();
 }
 
-void NetworkManager::handleSubmitResponse(QNetworkReply* reply, QJsonObject jsonObj)
+void NetworkManager::handleSurveySchemaReply(QNetworkReply* reply, const QString& surveyId, bool renderedFromCache)
 {
     FUNCTION_LOG();
-    LogFileManager::instance().logNetworkResponse("/public/saveAnswer", jsonObj.value("code").toInt(0), jsonObj);
-    if (jsonObj.value("code").toInt(0) == 200 || !jsonObj.contains("error")) {
-        emit submitSuccess();
-    } else {
-        QString errorMsg = "Failed to submit survey";
-        if (jsonObj.contains("message")) {
-            errorMsg = jsonObj["message"].toString();
-        } else if (jsonObj.contains("errorMsg")) {
-            errorMsg = jsonObj["errorMsg"].toString();
+    int httpStatus = reply ? reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() : 0;
+    if (httpStatus == 304) {
+        if (!renderedFromCache) {
+            emit surveySchemaReceived(m_schemaCache->model(surveyId));
         }
-        LogFileManager::instance().logError("SubmitError", errorMsg);
+        return;
+    }
 
-        emit submitFailed(errorMsg);
+    // reply为空表示服务器不可用，请求没有发出
+    bool hasCache = m_schemaCacheEnabled && m_schemaCache->entry(surveyId);
+    if (!reply || reply->error() != QNetworkReply::NoError) {
+        QString errorStr = reply ? reply->errorString() : QString("服务器暂时无法访问，请稍后再试");
+        if (reply) {
+            LogFileManager::instance().logError("NetworkError", errorStr, "Error code: " + QString::number(reply->error()));
+        }
+        if (!hasCache) {
+            reportNetworkFailure("/public/loadProject", errorStr);
+        } else if (!renderedFromCache) {
+            // 离线时使用可能过期的缓存，总比无法答题好
+            qWarning() << "问卷结构更新失败，使用缓存:" << surveyId << errorStr;
+            emit surveySchemaReceived(m_schemaCache->model(surveyId));
+        }
+        return;
+    }
+
+    if (!reply->property("schemaCached").toBool()) {
+        // 没有启用缓存或错误响应，在网络线程中编译问卷模型，界面线程直接使用
+        QJsonObject jsonObj = QJsonDocument::fromJson(replyBody(reply)).object();
+        // SurveyKing returns the full project info directly
+        // Check if the response contains data field
+        QJsonObject schema = jsonObj.contains("data") ? jsonObj["data"].toObject() : jsonObj;
+        emit surveySchemaReceived(SurveyModel::build(schema));
+        return;
+    }
 
+    // 内容没有变化时不重新编译，已显示的缓存继续使用
+    if (reply->property("schemaChanged").toBool() || !renderedFromCache) {
+        emit surveySchemaReceived(m_schemaCache->model(surveyId));
     }
 }
@@ -0,0 +1,159 @@
+#include "questionpagehost.h"
+#include <QVBoxLayout>
+
+QuestionPageHost::QuestionPageHost(QStackedWidget *stackedWidget, QuestionViewPool *viewPool,
+                                   int windowSize, QObject *parent)
+    : QObject(parent)
+    , m_stackedWidget(stackedWidget)
+    , m_viewPool(viewPool)
+    , m_model(SurveyModelPtr::create())
+{
+    // 槽位页面只创建一次
+    m_slots.resize(qMax(1, windowSize));
+    for (PageSlot& slot : m_slots) {
+        slot.page = new QWidget;
+        QVBoxLayout *pageLayout = new QVBoxLayout(slot.page);
+        pageLayout->setContentsMargins(0, 0, 0, 0);
+        m_stackedWidget->addWidget(slot.page);
+    }
+}
+
+void QuestionPageHost::reset(const SurveyModelPtr& model)
+{
+    for (PageSlot& slot : m_slots) {
+        recycle(slot);
+    }
+    m_model = model ? model : SurveyModelPtr::create();
+}
+
+QuestionView *QuestionPageHost::materialize(int questionIndex, bool *created)
+{
+    if (created) {
+        *created = false;
+    }
+    if (questionIndex < 0 || questionIndex >= m_model->visibleCount()) {
+        return nullptr;
+    }
+
+    int slotIndex = slotOf(questionIndex);
+    if (slotIndex < 0) {
+        // 优先使用空闲槽位
+        for (int i = 0; i < m_slots.size() && slotIndex < 0; ++i) {
+            if (m_slots[i].questionIndex < 0) {
+                slotIndex = i;
+            }
+        }
+        bool hasFreeSlot = slotIndex >= 0;
+        // 否则回收最久未使用的页面（当前显示的页面除外）
+        for (int i = 0; i < m_slots.size() && !hasFreeSlot; ++i) {
+            if (m_slots[i].page == m_stackedWidget->currentWidget()) {
+                continue;
+            }
+            if (slotIndex < 0 || m_slots[i].lastUsed < m_slots[slotIndex].lastUsed) {
+                slotIndex = i;
+            }
+        }
+        if (slotIndex < 0) {
+            slotIndex = 0;
+        }
+
+        PageSlot& slot = m_slots[slotIndex];
+        recycle(slot);
+
+        slot.view = m_viewPool->acquire(m_model->visibleQuestion(questionIndex));
+        slot.questionIndex = questionIndex;
+
+        QVBoxLayout *pageLayout = qobject_cast<QVBoxLayout*>(slot.page->layout());
+        pageLayout->addWidget(slot.view);
+        pageLayout->addStretch();
+        slot.view->show();
+
+        if (created) {
+            *created = true;
+        }
+    }
+
+    PageSlot& slot = m_slots[slotIndex];
+    slot.lastUsed = ++m_useCounter;
+    return slot.view;
+}
+
+void QuestionPageHost::show(int questionIndex)
+{
+    materialize(questionIndex);
+    int slotIndex = slotOf(questionIndex);
+    if (slotIndex >= 0) {
+        m_stackedWidget->setCurrentWidget(m_slots[slotIndex].page);
+    }
+}
+
+void QuestionPageHost::retain(const QList<int>& questionIndexes)
+{
+    for (PageSlot& slot : m_slots) {
+        if (slot.questionIndex >= 0 && !questionIndexes.contains(slot.questionIndex)) {
+            recycle(slot);
+        }
+    }
+}
+
+QuestionView *QuestionPageHost::view(int questionIndex) const
+{
+    int slotIndex = slotOf(questionIndex);
+    return slotIndex >= 0 ? m_slots[slotIndex].view : nullptr;
+}
+
+QWidget *QuestionPageHost::page(int questionIndex) const
+{
+    int slotIndex = slotOf(questionIndex);
+    return slotIndex >= 0 ? m_slots[slotIndex].page : nullptr;
+}
+
+int QuestionPageHost::indexOfView(const QuestionView *view) const
+{
+    for (const PageSlot& slot : m_slots) {
+        if (slot.view == view) {
+            return slot.questionIndex;
+        }
+    }
+    return -1;
+}
+
+QList<QuestionView*> QuestionPageHost::liveViews() const
+{
+    QList<QuestionView*> views;
+    for (const PageSlot& slot : m_slots) {
+        if (slot.view) {
+            views.append(slot.view);
+        }
+    }
+    return views;
+}
+
+int QuestionPageHost::slotOf(int questionIndex) const
+{
+    if (questionIndex < 0) {
+        return -1;
+    }
+    for (int i = 0; i < m_slots.size(); ++i) {
+        if (m_slots[i].questionIndex == questionIndex) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void QuestionPageHost::recycle(PageSlot& slot)
+{
+    // 题目控件归还控件池，清除页面上残留的布局项
+    if (slot.view) {
+        m_viewPool->release(slot.view);
+        slot.view = nullptr;
+    }
+    QLayout *pageLayout = slot.page->layout();
+    QLayoutItem *item;
+    while ((item = pageLayout->takeAt(0)) != nullptr) {
+        delete item;
+    }
+    slot.questionIndex = -1;
+    slot.lastUsed = 0;
+}
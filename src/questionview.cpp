@@ -0,0 +1,574 @@
+#include "questionview.h"
+#include <QRadioButton>
+#include <QCheckBox>
+
+QuestionView::QuestionView(QuestionType type, QWidget *parent)
+    : QGroupBox(parent)
+    , m_type(type)
+{
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::MinimumExpanding);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setSpacing(12);
+
+    m_titleLabel = new QLabel;
+    m_titleLabel->setWordWrap(true);
+    m_titleLabel->setTextFormat(Qt::RichText);
+    layout->addWidget(m_titleLabel);
+
+    m_descriptionLabel = new QLabel;
+    m_descriptionLabel->setWordWrap(true);
+    layout->addWidget(m_descriptionLabel);
+
+    m_contentLayout = new QVBoxLayout;
+    m_contentLayout->setContentsMargins(0, 0, 0, 0);
+    layout->addLayout(m_contentLayout);
+}
+
+void QuestionView::bind(const SurveyQuestion& question)
+{
+    m_questionId = question.id;
+
+    QString questionText = QString("<html><body><p style='font-size:16px; font-weight:bold; margin:0; color:#2c3e50;'>%1%2</p></body></html>")
+                          .arg(question.title)
+                          .arg(question.required ? "<span style='color:#e74c3c;'> *</span>" : "");
+    m_titleLabel->setText(questionText);
+
+    // 如果有题目描述，则显示题目描述
+    m_descriptionLabel->setText(question.description);
+    m_descriptionLabel->setVisible(!question.description.isEmpty());
+
+    bindContent(question);
+}
+
+// ---------------------------------------------------------------------------
+
+LineQuestionView::LineQuestionView(QuestionType type, QWidget *parent)
+    : QuestionView(type, parent)
+{
+    m_lineEdit = new QLineEdit;
+    contentLayout()->addWidget(m_lineEdit);
+    connect(m_lineEdit, &QLineEdit::textChanged, this, &QuestionView::answerEdited);
+}
+
+void LineQuestionView::bindContent(const SurveyQuestion& question)
+{
+    // 未识别的题型没有选项id，答案键为空字符串
+    m_optionId = (type() == QuestionType::FillBlank && !question.options.isEmpty()) ? question.options.last().id : QString();
+    m_lineEdit->clear();
+}
+
+QJsonObject LineQuestionView::answer() const
+{
+    QString value = m_lineEdit->text();
+    if (value.isEmpty() || (type() == QuestionType::FillBlank && m_optionId.isEmpty())) {
+        return QJsonObject();
+    }
+    // 格式: {"optionId": "value"}
+    return QJsonObject{{m_optionId, value}};
+}
+
+void LineQuestionView::setAnswer(const QJsonObject& answer)
+{
+    if (!answer.isEmpty()) {
+        m_lineEdit->setText(answer.begin().value().toString());
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+TextareaQuestionView::TextareaQuestionView(QWidget *parent)
+    : QuestionView(QuestionType::Textarea, parent)
+{
+    m_textEdit = new QTextEdit;
+    m_textEdit->setMaximumHeight(150);
+    contentLayout()->addWidget(m_textEdit);
+    connect(m_textEdit, &QTextEdit::textChanged, this, &QuestionView::answerEdited);
+}
+
+void TextareaQuestionView::bindContent(const SurveyQuestion& question)
+{
+    m_optionId = question.options.isEmpty() ? QString() : question.options.last().id;
+    m_textEdit->clear();
+}
+
+QJsonObject TextareaQuestionView::answer() const
+{
+    QString value = m_textEdit->toPlainText();
+    if (value.isEmpty() || m_optionId.isEmpty()) {
+        return QJsonObject();
+    }
+    return QJsonObject{{m_optionId, value}};
+}
+
+void TextareaQuestionView::setAnswer(const QJsonObject& answer)
+{
+    if (!answer.isEmpty()) {
+        m_textEdit->setPlainText(answer.begin().value().toString());
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+ChoiceQuestionView::ChoiceQuestionView(QuestionType type, QWidget *parent)
+    : QuestionView(type, parent)
+{
+    m_buttonGroup = new QButtonGroup(this);
+    m_buttonGroup->setExclusive(type == QuestionType::Radio); // 多选题非独占
+    contentLayout()->setSpacing(10);
+}
+
+ChoiceQuestionView::OptionRow& ChoiceQuestionView::rowAt(int index)
+{
+    while (m_rows.size() <= index) {
+        OptionRow row;
+        row.widget = new QWidget;
+        QHBoxLayout *rowLayout = new QHBoxLayout(row.widget);
+        rowLayout->setContentsMargins(0, 0, 0, 0);
+
+        if (type() == QuestionType::Radio) {
+            row.button = new QRadioButton;
+        } else {
+            row.button = new QCheckBox;
+        }
+        row.label = new QLabel;
+        row.blankEdit = new QLineEdit;
+        row.blankEdit->setPlaceholderText("请输入");
+        row.blankEdit->setEnabled(false); // 默认禁用，选中选项后启用
+
+        QLineEdit *blankEdit = row.blankEdit;
+        connect(row.button, &QAbstractButton::toggled, this, [blankEdit](bool checked) {
+            blankEdit->setEnabled(checked);
+            if (!checked) {
+                blankEdit->clear();
+            }
+        });
+        connect(row.button, &QAbstractButton::toggled, this, &QuestionView::answerEdited);
+        connect(row.blankEdit, &QLineEdit::textChanged, this, &QuestionView::answerEdited);
+
+        rowLayout->addWidget(row.button);
+        rowLayout->addWidget(row.label);
+        rowLayout->addWidget(row.blankEdit);
+        rowLayout->addStretch();
+
+        m_buttonGroup->addButton(row.button, m_rows.size());
+        contentLayout()->addWidget(row.widget);
+        m_rows.append(row);
+    }
+    return m_rows[index];
+}
+
+void ChoiceQuestionView::bindContent(const SurveyQuestion& question)
+{
+    // 清除上一道题的选择，独占模式下无法直接取消选中
+    m_buttonGroup->setExclusive(false);
+    for (int i = 0; i < m_rowCount; ++i) {
+        m_rows[i].button->setChecked(false);
+    }
+    m_buttonGroup->setExclusive(type() == QuestionType::Radio);
+
+    m_rowIndex.clear();
+    m_rowCount = question.options.size();
+    for (int j = 0; j < m_rowCount; ++j) {
+        const SurveyOption& option = question.options[j];
+        OptionRow& row = rowAt(j);
+        row.optionId = option.id;
+        row.blankId = option.blankId;
+        row.hasBlank = option.hasBlank;
+
+        if (option.hasBlank) {
+            // 提取下划线前的文本作为标签
+            QString label = option.title;
+            label.replace("____________", "");
+            row.button->setText(QString());
+            row.label->setText(label);
+        } else {
+            row.button->setText(option.title);
+            row.label->clear();
+        }
+        row.label->setVisible(option.hasBlank);
+        row.blankEdit->setVisible(option.hasBlank);
+        row.blankEdit->clear();
+        row.blankEdit->setEnabled(false);
+        row.widget->setVisible(true);
+
+        m_rowIndex.insert(option.id, j);
+    }
+
+    // 多余的行隐藏，留给选项更多的题目使用
+    for (int j = m_rowCount; j < m_rows.size(); ++j) {
+        m_rows[j].widget->setVisible(false);
+    }
+}
+
+QJsonObject ChoiceQuestionView::answer() const
+{
+    // 格式: {"optionId": "optionText", "optionId": {"blankId": "value"}}
+    QJsonObject valueObj;
+    for (int j = 0; j < m_rowCount; ++j) {
+        const OptionRow& row = m_rows[j];
+        if (!row.button->isChecked()) {
+            continue;
+        }
+        valueObj[row.optionId] = row.button->text();
+        if (row.hasBlank && !row.blankEdit->text().isEmpty()) {
+            valueObj[row.optionId] = QJsonObject{{row.blankId, row.blankEdit->text()}};
+        }
+    }
+    return valueObj;
+}
+
+void ChoiceQuestionView::setAnswer(const QJsonObject& answer)
+{
+    for (auto it = answer.constBegin(); it != answer.constEnd(); ++it) {
+        int index = m_rowIndex.value(it.key(), -1);
+        if (index < 0) {
+            continue;
+        }
+        OptionRow& row = m_rows[index];
+        row.button->setChecked(true); // 选中后关联的填空输入框随之启用
+
+        // 恢复选项中的填空输入框
+        QJsonObject subAnswer = it.value().toObject();
+        if (row.hasBlank && !subAnswer.isEmpty()) {
+            row.blankEdit->setEnabled(true);
+            row.blankEdit->setText(subAnswer.begin().value().toString());
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+SelectQuestionView::SelectQuestionView(QWidget *parent)
+    : QuestionView(QuestionType::Select, parent)
+{
+    m_comboBox = new QComboBox;
+    contentLayout()->addWidget(m_comboBox);
+    connect(m_comboBox, &QComboBox::currentIndexChanged, this, &QuestionView::answerEdited);
+}
+
+void SelectQuestionView::bindContent(const SurveyQuestion& question)
+{
+    m_comboBox->clear();
+    // 添加空选项作为默认选项
+    m_comboBox->addItem("请选择");
+    for (const SurveyOption& option : question.options) {
+        m_comboBox->addItem(option.title, option.id);
+    }
+}
+
+QJsonObject SelectQuestionView::answer() const
+{
+    if (m_comboBox->currentIndex() <= 0) { // 排除"请选择"
+        return QJsonObject();
+    }
+    // 格式: {"optionId": "optionId"}
+    QString value = m_comboBox->currentData().toString();
+    return QJsonObject{{value, value}};
+}
+
+void SelectQuestionView::setAnswer(const QJsonObject& answer)
+{
+    for (int i = 1; i < m_comboBox->count(); ++i) {
+        if (answer.contains(m_comboBox->itemData(i).toString())) {
+            m_comboBox->setCurrentIndex(i);
+            break;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+MultipleBlankQuestionView::MultipleBlankQuestionView(QWidget *parent)
+    : QuestionView(QuestionType::MultipleBlank, parent)
+{
+}
+
+void MultipleBlankQuestionView::bindContent(const SurveyQuestion& question)
+{
+    m_rowCount = question.options.size();
+    for (int j = 0; j < m_rowCount; ++j) {
+        if (j == m_rows.size()) {
+            BlankRow row;
+            row.widget = new QWidget;
+            QHBoxLayout *blankLayout = new QHBoxLayout(row.widget);
+            blankLayout->setContentsMargins(0, 0, 0, 0);
+            row.label = new QLabel;
+            row.lineEdit = new QLineEdit;
+            blankLayout->addWidget(row.label);
+            blankLayout->addWidget(row.lineEdit);
+            connect(row.lineEdit, &QLineEdit::textChanged, this, &QuestionView::answerEdited);
+            contentLayout()->addWidget(row.widget);
+            m_rows.append(row);
+        }
+
+        BlankRow& row = m_rows[j];
+        row.blankId = question.options[j].id;
+        row.label->setText(question.options[j].title + ":");
+        row.lineEdit->clear();
+        row.widget->setVisible(true);
+    }
+
+    for (int j = m_rowCount; j < m_rows.size(); ++j) {
+        m_rows[j].widget->setVisible(false);
+    }
+}
+
+QJsonObject MultipleBlankQuestionView::answer() const
+{
+    // 格式: {"blankId": "value"}
+    QJsonObject valueObj;
+    for (int j = 0; j < m_rowCount; ++j) {
+        const BlankRow& row = m_rows[j];
+        if (!row.lineEdit->text().isEmpty() && !row.blankId.isEmpty()) {
+            valueObj[row.blankId] = row.lineEdit->text();
+        }
+    }
+    return valueObj;
+}
+
+void MultipleBlankQuestionView::setAnswer(const QJsonObject& answer)
+{
+    for (int j = 0; j < m_rowCount; ++j) {
+        BlankRow& row = m_rows[j];
+        if (answer.contains(row.blankId)) {
+            row.lineEdit->setText(answer[row.blankId].toString());
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+ScoreQuestionView::ScoreQuestionView(QuestionType type, QWidget *parent)
+    : QuestionView(type, parent)
+{
+    m_slider = new QSlider(Qt::Horizontal);
+    m_slider->setRange(0, 10);
+    m_slider->setValue(0);
+    m_slider->setTickPosition(QSlider::TicksBelow);
+    m_slider->setTickInterval(1);
+
+    QHBoxLayout *scoreLabelsLayout = new QHBoxLayout;
+    for (int i = 0; i <= 10; ++i) {
+        QLabel *label = new QLabel(QString::number(i));
+        label->setAlignment(Qt::AlignCenter);
+        scoreLabelsLayout->addWidget(label);
+    }
+
+    contentLayout()->addWidget(m_slider);
+    contentLayout()->addLayout(scoreLabelsLayout);
+    connect(m_slider, &QSlider::valueChanged, this, &QuestionView::answerEdited);
+}
+
+void ScoreQuestionView::bindContent(const SurveyQuestion&)
+{
+    m_slider->setValue(0);
+}
+
+QJsonObject ScoreQuestionView::answer() const
+{
+    // 格式: {"questionId": "value"}
+    return QJsonObject{{questionId(), QString::number(m_slider->value())}};
+}
+
+void ScoreQuestionView::setAnswer(const QJsonObject& answer)
+{
+    bool ok;
+    int value = answer[questionId()].toString().toInt(&ok);
+    if (ok) {
+        m_slider->setValue(value);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+CascaderQuestionView::CascaderQuestionView(QWidget *parent)
+    : QuestionView(QuestionType::Cascader, parent)
+{
+    m_firstLevelCombo = new QComboBox;
+    m_firstLevelCombo->addItem("请选择");
+    // 添加示例选项
+    m_firstLevelCombo->addItem("选项1", "opt1");
+    m_firstLevelCombo->addItem("选项2", "opt2");
+
+    m_secondLevelCombo = new QComboBox;
+    m_secondLevelCombo->addItem("请选择");
+    m_secondLevelCombo->setEnabled(false);
+
+    contentLayout()->addWidget(m_firstLevelCombo);
+    contentLayout()->addWidget(m_secondLevelCombo);
+
+    // 连接级联逻辑
+    QComboBox *secondLevelCombo = m_secondLevelCombo;
+    connect(m_firstLevelCombo, &QComboBox::currentTextChanged, this, [secondLevelCombo](const QString &text) {
+        secondLevelCombo->clear();
+        secondLevelCombo->addItem("请选择");
+        if (!text.isEmpty() && text != "请选择") {
+            secondLevelCombo->setEnabled(true);
+            secondLevelCombo->addItem("子选项1", "sub1");
+            secondLevelCombo->addItem("子选项2", "sub2");
+        } else {
+            secondLevelCombo->setEnabled(false);
+        }
+    });
+    connect(m_firstLevelCombo, &QComboBox::currentIndexChanged, this, &QuestionView::answerEdited);
+}
+
+void CascaderQuestionView::bindContent(const SurveyQuestion&)
+{
+    m_firstLevelCombo->setCurrentIndex(0);
+}
+
+QJsonObject CascaderQuestionView::answer() const
+{
+    if (m_firstLevelCombo->currentIndex() <= 0) {
+        return QJsonObject();
+    }
+    QString value = m_firstLevelCombo->currentData().toString();
+    return QJsonObject{{value, value}};
+}
+
+void CascaderQuestionView::setAnswer(const QJsonObject& answer)
+{
+    for (int i = 1; i < m_firstLevelCombo->count(); ++i) {
+        if (answer.contains(m_firstLevelCombo->itemData(i).toString())) {
+            m_firstLevelCombo->setCurrentIndex(i);
+            break;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+UploadQuestionView::UploadQuestionView(QWidget *parent)
+    : QuestionView(QuestionType::Upload, parent)
+{
+    QPushButton *uploadButton = new QPushButton("选择文件");
+    m_fileListLabel = new QLabel;
+    m_fileListLabel->setWordWrap(true);
+
+    contentLayout()->addWidget(uploadButton);
+    contentLayout()->addWidget(m_fileListLabel);
+
+    // 连接上传按钮点击事件
+    connect(uploadButton, &QPushButton::clicked, this, [this]() {
+        emit uploadRequested(questionId());
+    });
+}
+
+void UploadQuestionView::bindContent(const SurveyQuestion&)
+{
+    m_fileListLabel->setText("已选择文件：无");
+}
+
+void UploadQuestionView::setFileText(const QString& text)
+{
+    m_fileListLabel->setText(text);
+}
+
+// ---------------------------------------------------------------------------
+
+PlaceholderQuestionView::PlaceholderQuestionView(QuestionType type, QWidget *parent)
+    : QuestionView(type, parent)
+{
+    if (type == QuestionType::Signature) {
+        // 电子签名 - 添加签名区域
+        QLabel *signatureLabel = new QLabel("请在下方区域签名（模拟实现）");
+
+        // 签名显示区域
+        QLabel *signatureArea = new QLabel("签名区域");
+        signatureArea->setAlignment(Qt::AlignCenter);
+        signatureArea->setMinimumHeight(100);
+
+        QHBoxLayout *signatureButtonsLayout = new QHBoxLayout;
+        signatureButtonsLayout->addWidget(new QPushButton("签名"));
+        signatureButtonsLayout->addWidget(new QPushButton("清除"));
+        signatureButtonsLayout->addStretch();
+
+        contentLayout()->addWidget(signatureLabel);
+        contentLayout()->addWidget(signatureArea);
+        contentLayout()->addLayout(signatureButtonsLayout);
+    } else {
+        // 扫码题 - 添加扫码按钮
+        contentLayout()->addWidget(new QPushButton("扫描二维码"));
+
+        QLabel *barcodeResult = new QLabel("扫描结果将显示在这里");
+        barcodeResult->setWordWrap(true);
+        contentLayout()->addWidget(barcodeResult);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+QuestionViewPool::QuestionViewPool(QObject *parent)
+    : QObject(parent)
+{
+    m_parking = new QWidget;
+    m_parking->hide();
+}
+
+QuestionViewPool::~QuestionViewPool()
+{
+    // 池中空闲的控件都挂在m_parking下
+    delete m_parking;
+}
+
+QuestionView *QuestionViewPool::acquire(const SurveyQuestion& question)
+{
+    QVector<QuestionView*>& freeViews = m_free[static_cast<int>(question.type)];
+    QuestionView *view = freeViews.isEmpty() ? create(question.type) : freeViews.takeLast();
+    view->bind(question);
+    return view;
+}
+
+void QuestionViewPool::release(QuestionView *view)
+{
+    if (!view) {
+        return;
+    }
+    view->hide();
+    view->setParent(m_parking);
+    m_free[static_cast<int>(view->type())].append(view);
+}
+
+QuestionView *QuestionViewPool::create(QuestionType type)
+{
+    QuestionView *view = nullptr;
+    switch (type) {
+    case QuestionType::FillBlank:
+    case QuestionType::Other:
+        view = new LineQuestionView(type);
+        break;
+    case QuestionType::Textarea:
+        view = new TextareaQuestionView;
+        break;
+    case QuestionType::Radio:
+    case QuestionType::Checkbox:
+        view = new ChoiceQuestionView(type);
+        break;
+    case QuestionType::Select:
+        view = new SelectQuestionView;
+        break;
+    case QuestionType::MultipleBlank:
+        view = new MultipleBlankQuestionView;
+        break;
+    case QuestionType::Score:
+    case QuestionType::Nps:
+        view = new ScoreQuestionView(type);
+        break;
+    case QuestionType::Cascader:
+        view = new CascaderQuestionView;
+        break;
+    case QuestionType::Upload:
+        view = new UploadQuestionView;
+        break;
+    case QuestionType::Signature:
+    case QuestionType::Barcode:
+        view = new PlaceholderQuestionView(type);
+        break;
+    }
+
+    ++m_createdCount;
+    emit viewCreated(view);
+    return view;
+}
@@ -0,0 +1,83 @@
+#include "requestbody.h"
+#include <QJsonDocument>
+#include <QtEndian>
+#include <array>
+
+// gzip尾部需要的CRC-32（IEEE 802.3），Qt没有公开接口
+static quint32 gzipCrc32(const QByteArray& data)
+{
+    static const std::array<quint32, 256> table = [] {
+        std::array<quint32, 256> values;
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            values[i] = c;
+        }
+        return values;
+    }();
+
+    quint32 crc = 0xFFFFFFFFu;
+    for (char byte : data) {
+        crc = table[(crc ^ quint8(byte)) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+BodyEncoding parseBodyEncoding(const QString& name)
+{
+    QString value = name.trimmed().toLower();
+    if (value == "deflate") {
+        return BodyEncoding::Deflate;
+    }
+    if (value == "gzip") {
+        return BodyEncoding::Gzip;
+    }
+    return BodyEncoding::Identity;
+}
+
+QByteArray compressBody(const QByteArray& data, BodyEncoding encoding)
+{
+    if (encoding == BodyEncoding::Identity) {
+        return data;
+    }
+
+    // qCompress输出: 4字节原始长度 + zlib流(2字节头 + deflate数据 + 4字节Adler-32)
+    QByteArray zlib = qCompress(data, 6).mid(4);
+    if (encoding == BodyEncoding::Deflate) {
+        return zlib;
+    }
+
+    // gzip与zlib使用相同的deflate数据，只是头尾不同
+    QByteArray gzip;
+    gzip.reserve(zlib.size() + 12);
+    const char header[10] = {'\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, '\x03'};
+    gzip.append(header, sizeof(header));
+    gzip.append(zlib.constData() + 2, zlib.size() - 6);
+    uchar trailer[8];
+    qToLittleEndian<quint32>(gzipCrc32(data), trailer);
+    qToLittleEndian<quint32>(quint32(data.size()), trailer + 4);
+    gzip.append(reinterpret_cast<const char*>(trailer), sizeof(trailer));
+    return gzip;
+}
+
+QByteArray encodeRequestBody(const QJsonObject& body, BodyEncoding encoding, QByteArray *contentEncoding, int minSize)
+{
+    if (contentEncoding) {
+        contentEncoding->clear();
+    }
+    QByteArray json = QJsonDocument(body).toJson(QJsonDocument::Compact);
+    if (encoding == BodyEncoding::Identity || json.size() < minSize) {
+        return json;
+    }
+
+    QByteArray compressed = compressBody(json, encoding);
+    if (compressed.size() >= json.size()) {
+        return json;
+    }
+    if (contentEncoding) {
+        *contentEncoding = encoding == BodyEncoding::Gzip ? "gzip" : "deflate";
+    }
+    return compressed;
+}
@@ -0,0 +1,192 @@
+#include "retrypolicy.h"
+#include <QDateTime>
+#include <QRandomGenerator>
+#include <QDebug>
+
+// 探测请求没有结果（如被取消）时，超过这个时间再放行下一个
+static const qint64 ProbeTimeoutMs = 60000;
+// 主动中止的请求在响应对象上做的标记
+static const char AbortedByClientProperty[] = "abortedByClient";
+
+void RetryController::setCircuitBreaker(int failureThreshold, int cooldownMs, int maxCooldownMs)
+{
+    m_failureThreshold = qMax(1, failureThreshold);
+    m_cooldownMs = qMax(1000, cooldownMs);
+    m_maxCooldownMs = qMax(m_cooldownMs, maxCooldownMs);
+}
+
+qint64 RetryController::blockedFor(const QString& endpoint)
+{
+    EndpointHealth& health = m_health[endpoint];
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    if (health.state == EndpointHealth::Open) {
+        if (now < health.openUntil) {
+            ++health.rejected;
+            return health.openUntil - now;
+        }
+        health.state = EndpointHealth::HalfOpen;
+        health.probeStartedAt = 0;
+    }
+    if (health.state == EndpointHealth::HalfOpen) {
+        if (health.probeStartedAt > 0 && now - health.probeStartedAt < ProbeTimeoutMs) {
+            ++health.rejected;
+            return ProbeTimeoutMs - (now - health.probeStartedAt);
+        }
+        health.probeStartedAt = now;
+    }
+    ++health.requests;
+    return 0;
+}
+
+int RetryController::backoffDelay(const QString& endpoint, int attempt) const
+{
+    RetryPolicy retryPolicy = policy(endpoint);
+    // 指数退避，抖动取上限的一半到全部之间，避免多台设备同时重试
+    qint64 ceiling = qMin<qint64>(retryPolicy.maxDelayMs, qint64(retryPolicy.baseDelayMs) << qBound(0, attempt, 20));
+    qint64 half = ceiling / 2;
+    return int(half + QRandomGenerator::global()->bounded(half + 1));
+}
+
+void RetryController::recordSuccess(const QString& endpoint, int attempt)
+{
+    EndpointHealth& health = m_health[endpoint];
+    if (health.state != EndpointHealth::Closed) {
+        qDebug() << "接口恢复:" << endpoint;
+    }
+    health.state = EndpointHealth::Closed;
+    health.consecutiveFailures = 0;
+    health.openCount = 0;
+    health.probeStartedAt = 0;
+    health.openNoticed = false;
+    if (attempt > 0) {
+        ++health.recovered;
+    }
+}
+
+int RetryController::recordFailure(const QString& endpoint, int attempt, bool retryable)
+{
+    EndpointHealth& health = m_health[endpoint];
+    ++health.failures;
+    health.probeStartedAt = 0;
+    if (!retryable) {
+        // 服务器正常响应了错误，不计入熔断
+        return -1;
+    }
+
+    // 熔断前已发出的请求陆续失败时不再延长冷却时间
+    ++health.consecutiveFailures;
+    if (health.state == EndpointHealth::HalfOpen
+        || (health.state == EndpointHealth::Closed && health.consecutiveFailures >= m_failureThreshold)) {
+        open(health);
+        qWarning() << "接口连续失败，暂停请求:" << endpoint << health.consecutiveFailures
+                   << "冷却" << health.openUntil - QDateTime::currentMSecsSinceEpoch() << "ms";
+    }
+    if (health.state == EndpointHealth::Open || attempt >= policy(endpoint).maxRetries) {
+        return -1;
+    }
+
+    ++health.retries;
+    health.lastBackoffMs = backoffDelay(endpoint, attempt);
+    return health.lastBackoffMs;
+}
+
+bool RetryController::takeOpenNotice(const QString& endpoint)
+{
+    EndpointHealth& health = m_health[endpoint];
+    if (health.openNoticed) {
+        return false;
+    }
+    health.openNoticed = true;
+    return true;
+}
+
+bool RetryController::isOpen(const QString& endpoint) const
+{
+    auto it = m_health.constFind(endpoint);
+    return it != m_health.constEnd() && it->state != EndpointHealth::Closed;
+}
+
+void RetryController::resetCircuits()
+{
+    for (EndpointHealth& health : m_health) {
+        health.state = EndpointHealth::Closed;
+        health.consecutiveFailures = 0;
+        health.openCount = 0;
+        health.probeStartedAt = 0;
+        health.openNoticed = false;
+    }
+}
+
+bool RetryController::isRetryable(QNetworkReply::NetworkError error, int httpStatus)
+{
+    if (httpStatus == 408 || httpStatus == 429 || httpStatus >= 500) {
+        return true;
+    }
+    switch (error) {
+    case QNetworkReply::ConnectionRefusedError:
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::HostNotFoundError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::OperationCanceledError:     // 传输超时，主动中止的请求由isRetryable(reply)排除
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::UnknownNetworkError:
+    case QNetworkReply::ProxyConnectionClosedError:
+    case QNetworkReply::ProxyTimeoutError:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool RetryController::isRetryable(const QNetworkReply *reply)
+{
+    if (isAbortedByClient(reply)) {
+        return false;
+    }
+    return isRetryable(reply->error(), reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt());
+}
+
+void RetryController::abortReply(QNetworkReply *reply)
+{
+    // abort()会同步发出finished，标记要在中止之前设置
+    reply->setProperty(AbortedByClientProperty, true);
+    reply->abort();
+}
+
+bool RetryController::isAbortedByClient(const QNetworkReply *reply)
+{
+    return reply->property(AbortedByClientProperty).toBool();
+}
+
+QJsonObject RetryController::metrics() const
+{
+    static const char *stateNames[] = {"closed", "open", "halfOpen"};
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QJsonObject result;
+    for (auto it = m_health.constBegin(); it != m_health.constEnd(); ++it) {
+        const EndpointHealth& health = it.value();
+        result[it.key()] = QJsonObject{
+            {"state", stateNames[health.state]},
+            {"requests", qint64(health.requests)},
+            {"failures", qint64(health.failures)},
+            {"retries", qint64(health.retries)},
+            {"recovered", qint64(health.recovered)},
+            {"rejected", qint64(health.rejected)},
+            {"consecutiveFailures", health.consecutiveFailures},
+            {"lastBackoffMs", health.lastBackoffMs},
+            {"openForMs", health.state == EndpointHealth::Open ? qMax<qint64>(0, health.openUntil - now) : 0}
+        };
+    }
+    return result;
+}
+
+void RetryController::open(EndpointHealth& health)
+{
+    qint64 cooldown = qMin<qint64>(m_maxCooldownMs, qint64(m_cooldownMs) << qMin(health.openCount, 10));
+    health.state = EndpointHealth::Open;
+    health.openUntil = QDateTime::currentMSecsSinceEpoch() + cooldown;
+    health.openNoticed = false;
+    ++health.openCount;
+}
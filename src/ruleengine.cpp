@@ -0,0 +1,124 @@
+#include "ruleengine.h"
+#include "answerstore.h"
+
+SurveyRuleEngine::SurveyRuleEngine(SurveyAnswerStore *answers, QObject *parent)
+    : QObject(parent)
+    , m_answers(answers)
+{
+    connect(m_answers, &SurveyAnswerStore::answerChanged, this, &SurveyRuleEngine::onAnswerChanged);
+}
+
+void SurveyRuleEngine::setOptionTitleLookup(const RuleExpression::OptionTitleLookup& lookup)
+{
+    m_optionTitle = lookup;
+}
+
+void SurveyRuleEngine::clear()
+{
+    m_jumpRules.clear();
+    m_finishRules.clear();
+    m_globalRules.clear();
+    m_jumpResults.clear();
+    m_finishResults.clear();
+    m_globalResults.clear();
+    m_dependents.clear();
+}
+
+void SurveyRuleEngine::addQuestionRules(const RuleExpression& jumpRule, const RuleExpression& finishRule)
+{
+    int index = m_jumpRules.size();
+
+    m_jumpRules.append(jumpRule);
+    m_jumpResults.append(NotCached);
+    addDependencies(jumpRule.referencedQuestions(), JumpRule, index);
+
+    m_finishRules.append(finishRule);
+    m_finishResults.append(NotCached);
+    addDependencies(finishRule.referencedQuestions(), FinishRule, index);
+}
+
+void SurveyRuleEngine::addGlobalRule(const GlobalRule& rule)
+{
+    int index = m_globalRules.size();
+
+    m_globalRules.append(rule);
+    m_globalResults.append(NotCached);
+    addDependencies(rule.referencedQuestions(), GlobalRuleKind, index);
+}
+
+bool SurveyRuleEngine::jumpRuleMatched(int questionIndex)
+{
+    if (questionIndex < 0 || questionIndex >= m_jumpRules.size() || !m_jumpRules[questionIndex].isValid()) {
+        return false;
+    }
+
+    CachedResult& cached = m_jumpResults[questionIndex];
+    if (cached == NotCached) {
+        cached = evaluate(m_jumpRules[questionIndex]) ? ResultTrue : ResultFalse;
+    }
+    return cached == ResultTrue;
+}
+
+bool SurveyRuleEngine::finishRuleMatched(int questionIndex)
+{
+    if (questionIndex < 0 || questionIndex >= m_finishRules.size() || !m_finishRules[questionIndex].isValid()) {
+        return false;
+    }
+
+    CachedResult& cached = m_finishResults[questionIndex];
+    if (cached == NotCached) {
+        cached = evaluate(m_finishRules[questionIndex]) ? ResultTrue : ResultFalse;
+    }
+    return cached == ResultTrue;
+}
+
+bool SurveyRuleEngine::globalRuleResult(int ruleIndex)
+{
+    if (ruleIndex < 0 || ruleIndex >= m_globalRules.size()) {
+        return false;
+    }
+
+    CachedResult& cached = m_globalResults[ruleIndex];
+    if (cached == NotCached) {
+        const GlobalRule& rule = m_globalRules[ruleIndex];
+        bool result = rule.kind() == GlobalRule::Structured ? rule.conditionsMet(*m_answers)
+                                                            : evaluate(rule.expression());
+        cached = result ? ResultTrue : ResultFalse;
+    }
+    return cached == ResultTrue;
+}
+
+void SurveyRuleEngine::onAnswerChanged(const QString& questionId)
+{
+    // 只让读取了该题答案的规则失效
+    auto it = m_dependents.constFind(questionId);
+    if (it == m_dependents.constEnd()) {
+        return;
+    }
+
+    for (const RuleRef& ref : it.value()) {
+        switch (ref.kind) {
+        case JumpRule:
+            m_jumpResults[ref.index] = NotCached;
+            break;
+        case FinishRule:
+            m_finishResults[ref.index] = NotCached;
+            break;
+        case GlobalRuleKind:
+            m_globalResults[ref.index] = NotCached;
+            break;
+        }
+    }
+}
+
+void SurveyRuleEngine::addDependencies(const QStringList& questionIds, RuleKind kind, int index)
+{
+    for (const QString& questionId : questionIds) {
+        m_dependents[questionId].append(RuleRef{kind, index});
+    }
+}
+
+bool SurveyRuleEngine::evaluate(const RuleExpression& rule) const
+{
+    return rule.evaluate(*m_answers, m_optionTitle);
+}
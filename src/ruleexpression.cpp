@@ -0,0 +1,611 @@
+#include "ruleexpression.h"
+#include "answerstore.h"
+#include <QVector>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QtMath>
+
+struct RuleExpression::Node
+{
+    enum Kind {
+        Literal,    // 字符串字面量
+        Number,     // 数字字面量
+        Boolean,    // true / false
+        Reference,  // #{questionId.subField}
+        Not,
+        And,
+        Or,
+        Compare,    // text 为比较运算符
+        Includes,   // includes(a, b)
+        Jump        // jump('questionId')，求值恒为true
+    };
+
+    Kind kind = Literal;
+    QString text;
+    QString subField;
+    double number = 0.0;
+    bool boolean = false;
+    QVector<QSharedPointer<const Node>> children;
+};
+
+namespace {
+
+using Node = RuleExpression::Node;
+using NodePtr = QSharedPointer<const Node>;
+
+struct Token
+{
+    enum Type { End, Reference, String, Number, Identifier, Operator, LParen, RParen, Comma };
+
+    Type type = End;
+    QString text;
+    QString subField;
+    double number = 0.0;
+};
+
+bool isOperand(const QVector<Token>& tokens)
+{
+    if (tokens.isEmpty()) {
+        return false;
+    }
+    Token::Type type = tokens.last().type;
+    return type == Token::Reference || type == Token::String || type == Token::Number
+           || type == Token::Identifier || type == Token::RParen;
+}
+
+bool tokenize(const QString& src, QVector<Token>& tokens, QString& error)
+{
+    const int n = src.size();
+    int i = 0;
+    while (i < n) {
+        const QChar c = src.at(i);
+        if (c.isSpace()) {
+            ++i;
+            continue;
+        }
+
+        Token token;
+        if (c == QLatin1Char('#') && i + 1 < n && src.at(i + 1) == QLatin1Char('{')) {
+            int close = src.indexOf(QLatin1Char('}'), i + 2);
+            if (close < 0) {
+                error = QString("位置%1: 缺少 }").arg(i);
+                return false;
+            }
+            QString ref = src.mid(i + 2, close - i - 2).trimmed();
+            int dot = ref.indexOf(QLatin1Char('.'));
+            token.type = Token::Reference;
+            token.text = dot < 0 ? ref : ref.left(dot);
+            token.subField = dot < 0 ? QString() : ref.mid(dot + 1);
+            i = close + 1;
+        } else if (c == QLatin1Char('\'') || c == QLatin1Char('"')) {
+            int close = src.indexOf(c, i + 1);
+            if (close < 0) {
+                error = QString("位置%1: 字符串未闭合").arg(i);
+                return false;
+            }
+            token.type = Token::String;
+            token.text = src.mid(i + 1, close - i - 1);
+            i = close + 1;
+        } else if (c.isDigit() || (c == QLatin1Char('-') && i + 1 < n && src.at(i + 1).isDigit() && !isOperand(tokens))) {
+            int start = i++;
+            while (i < n && (src.at(i).isDigit() || src.at(i) == QLatin1Char('.'))) {
+                ++i;
+            }
+            bool ok = false;
+            token.type = Token::Number;
+            token.text = src.mid(start, i - start);
+            token.number = token.text.toDouble(&ok);
+            if (!ok) {
+                error = QString("位置%1: 无效的数字 %2").arg(start).arg(token.text);
+                return false;
+            }
+        } else if (c.isLetter() || c == QLatin1Char('_')) {
+            int start = i++;
+            while (i < n && (src.at(i).isLetterOrNumber() || src.at(i) == QLatin1Char('_'))) {
+                ++i;
+            }
+            token.type = Token::Identifier;
+            token.text = src.mid(start, i - start);
+        } else if (c == QLatin1Char('(')) {
+            token.type = Token::LParen;
+            ++i;
+        } else if (c == QLatin1Char(')')) {
+            token.type = Token::RParen;
+            ++i;
+        } else if (c == QLatin1Char(',')) {
+            token.type = Token::Comma;
+            ++i;
+        } else {
+            static const QStringList twoCharOps = {"==", "!=", ">=", "<=", "&&", "||"};
+            QString two = src.mid(i, 2);
+            token.type = Token::Operator;
+            if (twoCharOps.contains(two)) {
+                token.text = two;
+                i += 2;
+            } else if (c == QLatin1Char('>') || c == QLatin1Char('<') || c == QLatin1Char('!')) {
+                token.text = QString(c);
+                ++i;
+            } else {
+                error = QString("位置%1: 无法识别的字符 %2").arg(i).arg(c);
+                return false;
+            }
+        }
+        tokens.append(token);
+    }
+
+    tokens.append(Token()); // End
+    return true;
+}
+
+NodePtr makeNode(Node::Kind kind, const QString& text = QString(), const QVector<NodePtr>& children = {})
+{
+    QSharedPointer<Node> node(new Node);
+    node->kind = kind;
+    node->text = text;
+    node->children = children;
+    return node;
+}
+
+// 递归下降解析: or -> and -> unary -> comparison -> operand
+class Parser
+{
+public:
+    explicit Parser(const QVector<Token>& tokens) : m_tokens(tokens) {}
+
+    NodePtr parse()
+    {
+        NodePtr root = parseOr();
+        if (root && peek().type != Token::End) {
+            fail("表达式末尾有多余内容");
+        }
+        return m_error.isEmpty() ? root : NodePtr();
+    }
+
+    QString error() const { return m_error; }
+    QString jumpTarget() const { return m_jumpTarget.isEmpty() ? m_literalTarget : m_jumpTarget; }
+    QStringList references() const { return m_references; }
+
+private:
+    const Token& peek() const { return m_tokens.at(m_pos); }
+    Token take() { return m_tokens.at(m_pos < m_tokens.size() - 1 ? m_pos++ : m_pos); }
+
+    bool acceptOperator(const QString& op)
+    {
+        if (peek().type == Token::Operator && peek().text == op) {
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    NodePtr fail(const QString& message)
+    {
+        if (m_error.isEmpty()) {
+            m_error = message;
+        }
+        return NodePtr();
+    }
+
+    NodePtr parseOr()
+    {
+        NodePtr left = parseAnd();
+        if (!left || !(peek().type == Token::Operator && peek().text == "||")) {
+            return left;
+        }
+        QVector<NodePtr> children{left};
+        while (acceptOperator("||")) {
+            NodePtr right = parseAnd();
+            if (!right) return NodePtr();
+            children.append(right);
+        }
+        return makeNode(Node::Or, QString(), children);
+    }
+
+    NodePtr parseAnd()
+    {
+        NodePtr left = parseUnary();
+        if (!left || !(peek().type == Token::Operator && peek().text == "&&")) {
+            return left;
+        }
+        QVector<NodePtr> children{left};
+        while (acceptOperator("&&")) {
+            NodePtr right = parseUnary();
+            if (!right) return NodePtr();
+            children.append(right);
+        }
+        return makeNode(Node::And, QString(), children);
+    }
+
+    NodePtr parseUnary()
+    {
+        if (acceptOperator("!")) {
+            NodePtr operand = parseUnary();
+            if (!operand) return NodePtr();
+            return makeNode(Node::Not, QString(), {operand});
+        }
+        return parseComparison();
+    }
+
+    NodePtr parseComparison()
+    {
+        NodePtr left = parseOperand();
+        if (!left) return NodePtr();
+
+        static const QStringList compareOps = {"==", "!=", ">", ">=", "<", "<="};
+        if (peek().type == Token::Operator && compareOps.contains(peek().text)) {
+            QString op = take().text;
+            NodePtr right = parseOperand();
+            if (!right) return NodePtr();
+            return makeNode(Node::Compare, op, {left, right});
+        }
+
+        // 独立出现的字符串字面量视为跳转目标，兼容 "条件 && 'questionId'" 的写法；
+        // 函数参数中的字面量（如 includes(#{q1}, 'opt2') 的选项id）不是跳转目标
+        if (left->kind == Node::Literal && m_argumentDepth == 0 && m_literalTarget.isEmpty()) {
+            m_literalTarget = left->text;
+        }
+        return left;
+    }
+
+    NodePtr parseOperand()
+    {
+        Token token = take();
+        switch (token.type) {
+        case Token::Reference: {
+            if (token.text.isEmpty()) {
+                return fail("空的题目引用");
+            }
+            if (!m_references.contains(token.text)) {
+                m_references.append(token.text);
+            }
+            QSharedPointer<Node> node(new Node);
+            node->kind = Node::Reference;
+            node->text = token.text;
+            node->subField = token.subField;
+            return node;
+        }
+        case Token::String:
+            return makeNode(Node::Literal, token.text);
+        case Token::Number: {
+            QSharedPointer<Node> node(new Node);
+            node->kind = Node::Number;
+            node->text = token.text;
+            node->number = token.number;
+            return node;
+        }
+        case Token::LParen: {
+            NodePtr inner = parseOr();
+            if (!inner) return NodePtr();
+            if (take().type != Token::RParen) {
+                return fail("缺少 )");
+            }
+            return inner;
+        }
+        case Token::Identifier:
+            return parseIdentifier(token);
+        default:
+            return fail(token.type == Token::End ? "表达式不完整" : QString("意外的符号 %1").arg(token.text));
+        }
+    }
+
+    NodePtr parseIdentifier(const Token& token)
+    {
+        QString name = token.text.toLower();
+        if (name == "true" || name == "false") {
+            QSharedPointer<Node> node(new Node);
+            node->kind = Node::Boolean;
+            node->boolean = (name == "true");
+            return node;
+        }
+
+        if (peek().type != Token::LParen || (name != "includes" && name != "jump")) {
+            return fail(QString("未知的标识符 %1").arg(token.text));
+        }
+        take(); // (
+
+        if (name == "jump") {
+            // jump('id') / jump(id)
+            Token target = take();
+            if (target.type != Token::String && target.type != Token::Identifier && target.type != Token::Number) {
+                return fail("jump() 需要题目id");
+            }
+            if (take().type != Token::RParen) {
+                return fail("jump() 缺少 )");
+            }
+            if (m_jumpTarget.isEmpty()) {
+                m_jumpTarget = target.text;
+            }
+            return makeNode(Node::Jump, target.text);
+        }
+
+        // 出错时整个表达式编译失败，不需要恢复层数
+        ++m_argumentDepth;
+        NodePtr haystack = parseOr();
+        if (!haystack) return NodePtr();
+        if (take().type != Token::Comma) {
+            return fail("includes() 需要两个参数");
+        }
+        NodePtr needle = parseOr();
+        if (!needle) return NodePtr();
+        --m_argumentDepth;
+        if (take().type != Token::RParen) {
+            return fail("includes() 缺少 )");
+        }
+        return makeNode(Node::Includes, QString(), {haystack, needle});
+    }
+
+    const QVector<Token>& m_tokens;
+    int m_pos = 0;
+    QString m_error;
+    QString m_jumpTarget;
+    QString m_literalTarget;
+    int m_argumentDepth = 0;    // 正在解析的函数参数层数
+    QStringList m_references;
+};
+
+// 求值过程中的值
+struct Value
+{
+    enum Type { Null, Text, Number, Boolean };
+
+    Type type = Null;
+    QString text;
+    double number = 0.0;
+    bool boolean = false;
+    bool isReference = false;
+    bool present = false;   // 引用的答案（或子字段）是否存在
+    QStringList items;      // 引用答案中的选项id和取值，用于includes
+};
+
+QString firstString(const QJsonObject& obj)
+{
+    for (auto it = obj.constBegin(); it != obj.constEnd(); ++it) {
+        if (it.value().isString()) {
+            return it.value().toString();
+        }
+    }
+    return QString();
+}
+
+void collectItems(const QJsonObject& obj, QStringList& items)
+{
+    for (auto it = obj.constBegin(); it != obj.constEnd(); ++it) {
+        items.append(it.key());
+        if (it.value().isString()) {
+            items.append(it.value().toString());
+        }
+    }
+}
+
+class Evaluator
+{
+public:
+    Evaluator(const SurveyAnswerStore& answers, const RuleExpression::OptionTitleLookup& optionTitle)
+        : m_answers(answers), m_optionTitle(optionTitle) {}
+
+    bool evalBool(const NodePtr& node) const
+    {
+        switch (node->kind) {
+        case Node::Not:
+            return !evalBool(node->children.first());
+        case Node::And:
+            for (const NodePtr& child : node->children) {
+                if (!evalBool(child)) return false;
+            }
+            return true;
+        case Node::Or:
+            for (const NodePtr& child : node->children) {
+                if (evalBool(child)) return true;
+            }
+            return false;
+        case Node::Compare:
+            return evalCompare(node);
+        case Node::Includes:
+            return evalIncludes(node);
+        case Node::Jump:
+            return true; // jump表示条件满足后执行跳转
+        default:
+            return truthy(evalValue(node, false));
+        }
+    }
+
+private:
+    Value evalValue(const NodePtr& node, bool titleFallback) const
+    {
+        Value value;
+        switch (node->kind) {
+        case Node::Literal:
+            value.type = Value::Text;
+            value.text = node->text;
+            break;
+        case Node::Number:
+            value.type = Value::Number;
+            value.number = node->number;
+            break;
+        case Node::Boolean:
+            value.type = Value::Boolean;
+            value.boolean = node->boolean;
+            break;
+        case Node::Reference:
+            value = resolveReference(node, titleFallback);
+            break;
+        default:
+            value.type = Value::Boolean;
+            value.boolean = evalBool(node);
+            break;
+        }
+        return value;
+    }
+
+    Value resolveReference(const NodePtr& node, bool titleFallback) const
+    {
+        Value value;
+        value.isReference = true;
+
+        QJsonObject answer = m_answers.answer(node->text);
+        if (node->subField.isEmpty()) {
+            value.present = !answer.isEmpty();
+            value.text = firstString(answer);
+            collectItems(answer, value.items);
+        } else {
+            QJsonValue sub = answer.value(node->subField);
+            value.present = !sub.isUndefined();
+            if (sub.isObject()) {
+                value.text = firstString(sub.toObject());
+                collectItems(sub.toObject(), value.items);
+            } else if (sub.isArray()) {
+                QJsonArray array = sub.toArray();
+                for (const QJsonValue& item : array) {
+                    value.items.append(item.toString());
+                }
+                value.text = value.items.isEmpty() ? QString() : value.items.first();
+            } else if (sub.isString()) {
+                value.text = sub.toString();
+                value.items.append(value.text);
+            } else if (titleFallback && m_optionTitle) {
+                // 子字段没有作答时取选项标题，"#{q1} == #{q1.opt1}" 即表示选中了opt1
+                value.text = m_optionTitle(node->text, node->subField);
+                if (!value.text.isEmpty()) {
+                    value.type = Value::Text;
+                }
+                return value;
+            }
+        }
+
+        if (value.present) {
+            value.type = Value::Text;
+        }
+        return value;
+    }
+
+    static bool truthy(const Value& value)
+    {
+        if (value.isReference) {
+            return value.present;
+        }
+        switch (value.type) {
+        case Value::Text: return !value.text.isEmpty();
+        case Value::Number: return !qFuzzyIsNull(value.number);
+        case Value::Boolean: return value.boolean;
+        default: return false;
+        }
+    }
+
+    static bool toNumber(const Value& value, double& number)
+    {
+        switch (value.type) {
+        case Value::Number:
+            number = value.number;
+            return true;
+        case Value::Boolean:
+            number = value.boolean ? 1.0 : 0.0;
+            return true;
+        case Value::Text: {
+            bool ok = false;
+            number = value.text.trimmed().toDouble(&ok);
+            return ok;
+        }
+        default:
+            return false;
+        }
+    }
+
+    bool evalCompare(const NodePtr& node) const
+    {
+        const NodePtr& lhs = node->children.at(0);
+        const NodePtr& rhs = node->children.at(1);
+        const QString& op = node->text;
+
+        // 两个题目引用相比较时，未作答的子字段取选项标题
+        bool bothReferences = lhs->kind == Node::Reference && rhs->kind == Node::Reference;
+        Value left = evalValue(lhs, bothReferences);
+        Value right = evalValue(rhs, bothReferences);
+
+        if (op == "==" || op == "!=") {
+            bool equal;
+            if (left.type == Value::Null || right.type == Value::Null) {
+                if (bothReferences) {
+                    equal = false; // 任一题目未作答则认为不相等
+                } else {
+                    // 未作答等价于空字符串
+                    equal = (left.type == Value::Null || left.text.isEmpty())
+                            && (right.type == Value::Null || right.text.isEmpty())
+                            && left.type != Value::Number && right.type != Value::Number;
+                }
+            } else if (left.type == Value::Boolean || right.type == Value::Boolean) {
+                equal = truthy(left) == truthy(right);
+            } else {
+                double a = 0.0;
+                double b = 0.0;
+                if ((left.type == Value::Number || right.type == Value::Number)
+                    && toNumber(left, a) && toNumber(right, b)) {
+                    equal = qFuzzyCompare(a + 1.0, b + 1.0);
+                } else {
+                    equal = left.text == right.text;
+                }
+            }
+            return op == "==" ? equal : !equal;
+        }
+
+        double a = 0.0;
+        double b = 0.0;
+        if (!toNumber(left, a) || !toNumber(right, b)) {
+            return false;
+        }
+        if (op == ">") return a > b;
+        if (op == ">=") return a >= b;
+        if (op == "<") return a < b;
+        if (op == "<=") return a <= b;
+        return false;
+    }
+
+    bool evalIncludes(const NodePtr& node) const
+    {
+        Value haystack = evalValue(node->children.at(0), false);
+        Value needle = evalValue(node->children.at(1), false);
+        QString target = needle.type == Value::Number ? node->children.at(1)->text : needle.text;
+        if (target.isEmpty()) {
+            return false;
+        }
+        if (haystack.isReference) {
+            return haystack.items.contains(target);
+        }
+        return haystack.text.contains(target);
+    }
+
+    const SurveyAnswerStore& m_answers;
+    const RuleExpression::OptionTitleLookup& m_optionTitle;
+};
+
+} // namespace
+
+RuleExpression RuleExpression::compile(const QString& source)
+{
+    RuleExpression expression;
+    expression.m_source = source;
+
+    if (source.trimmed().isEmpty()) {
+        expression.m_error = "空表达式";
+        return expression;
+    }
+
+    QVector<Token> tokens;
+    if (!tokenize(source, tokens, expression.m_error)) {
+        return expression;
+    }
+
+    Parser parser(tokens);
+    expression.m_root = parser.parse();
+    expression.m_error = parser.error();
+    expression.m_jumpTarget = parser.jumpTarget();
+    expression.m_references = parser.references();
+    return expression;
+}
+
+bool RuleExpression::evaluate(const SurveyAnswerStore& answers, const OptionTitleLookup& optionTitle) const
+{
+    if (m_root.isNull()) {
+        return false; // 无法解析的表达式按不满足处理
+    }
+    return Evaluator(answers, optionTitle).evalBool(m_root);
+}
@@ -0,0 +1,137 @@
+#include "schemacache.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QDir>
+#include <QJsonDocument>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+
+SchemaCache::SchemaCache(const QString& directory)
+    : m_directory(directory)
+{
+    QDir().mkpath(m_directory);
+}
+
+void SchemaCache::setServerVersion(const QString& projectId, const QString& updateAt)
+{
+    if (!projectId.isEmpty()) {
+        m_serverVersions.insert(projectId, updateAt);
+    }
+}
+
+const CachedSchema *SchemaCache::entry(const QString& projectId)
+{
+    auto it = m_entries.find(projectId);
+    if (it == m_entries.end()) {
+        // 没有缓存文件时也记录下来，避免每次打开都访问磁盘
+        CachedSchema cached;
+        cached.projectId = projectId;
+        QFile file(filePath(projectId));
+        if (file.open(QIODevice::ReadOnly)) {
+            QJsonObject obj = QJsonDocument::fromJson(file.readAll()).object();
+            cached.updateAt = obj["updateAt"].toString();
+            cached.etag = obj["etag"].toString();
+            cached.lastModified = obj["lastModified"].toString();
+            cached.digest = obj["digest"].toString().toLatin1();
+            cached.fetchedAt = obj["fetchedAt"].toVariant().toLongLong();
+            cached.schema = obj["schema"].toObject();
+        }
+        it = m_entries.insert(projectId, cached);
+    }
+    return it->schema.isEmpty() ? nullptr : &it.value();
+}
+
+SurveyModelPtr SchemaCache::model(const QString& projectId)
+{
+    if (!entry(projectId)) {
+        return SurveyModelPtr();
+    }
+    CachedSchema& cached = m_entries[projectId];
+    if (!cached.model) {
+        cached.model = SurveyModel::build(cached.schema);
+    }
+    return cached.model;
+}
+
+bool SchemaCache::isFresh(const QString& projectId)
+{
+    const CachedSchema *cached = entry(projectId);
+    QString version = m_serverVersions.value(projectId);
+    return cached && !version.isEmpty() && cached->updateAt == version;
+}
+
+bool SchemaCache::isStale(const QString& projectId)
+{
+    const CachedSchema *cached = entry(projectId);
+    QString version = m_serverVersions.value(projectId);
+    return cached && !version.isEmpty() && cached->updateAt != version;
+}
+
+bool SchemaCache::store(const QString& projectId, const QJsonObject& schema, const QString& updateAt,
+                        const QString& etag, const QString& lastModified)
+{
+    QByteArray digest = QCryptographicHash::hash(QJsonDocument(schema).toJson(QJsonDocument::Compact),
+                                                 QCryptographicHash::Sha1).toHex();
+    entry(projectId);
+    CachedSchema& cached = m_entries[projectId];
+    bool changed = cached.digest != digest || cached.schema.isEmpty();
+
+    cached.updateAt = updateAt;
+    cached.etag = etag;
+    cached.lastModified = lastModified;
+    cached.fetchedAt = QDateTime::currentMSecsSinceEpoch();
+    if (changed) {
+        cached.digest = digest;
+        cached.schema = schema;
+        cached.model.reset();
+    }
+    save(cached);
+    return changed;
+}
+
+void SchemaCache::revalidated(const QString& projectId, const QString& updateAt)
+{
+    if (!entry(projectId)) {
+        return;
+    }
+    CachedSchema& cached = m_entries[projectId];
+    if (!updateAt.isEmpty()) {
+        cached.updateAt = updateAt;
+    }
+    cached.fetchedAt = QDateTime::currentMSecsSinceEpoch();
+    save(cached);
+}
+
+void SchemaCache::remove(const QString& projectId)
+{
+    m_entries.remove(projectId);
+    QFile::remove(filePath(projectId));
+}
+
+QString SchemaCache::filePath(const QString& projectId) const
+{
+    // 项目id不一定能直接作为文件名
+    QByteArray name = QCryptographicHash::hash(projectId.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return m_directory + "/" + QString::fromLatin1(name) + ".json";
+}
+
+bool SchemaCache::save(const CachedSchema& entry) const
+{
+    QJsonObject obj{
+        {"projectId", entry.projectId},
+        {"updateAt", entry.updateAt},
+        {"etag", entry.etag},
+        {"lastModified", entry.lastModified},
+        {"digest", QString::fromLatin1(entry.digest)},
+        {"fetchedAt", entry.fetchedAt},
+        {"schema", entry.schema}
+    };
+    QSaveFile file(filePath(entry.projectId));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "无法写入问卷缓存:" << file.fileName() << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
@@ -0,0 +1,194 @@
+#include "serverselector.h"
+#include <QNetworkRequest>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QDebug>
+
+// 请求连续连接失败这么多次后切换服务器，偶尔一次失败不切换
+static const int RequestFailureThreshold = 2;
+// 新的服务器延迟低于当前的这个比例才切换
+static const double SwitchRatio = 0.7;
+
+ServerSelector::ServerSelector(QNetworkAccessManager *networkManager, QObject *parent)
+    : QObject(parent)
+    , m_networkManager(networkManager)
+{
+}
+
+void ServerSelector::setServers(const QStringList& baseUrls, const QString& preferred)
+{
+    m_servers.clear();
+    m_probing.clear();
+    m_current = 0;
+    for (const QString& baseUrl : baseUrls) {
+        QString url = baseUrl.trimmed();
+        while (url.endsWith('/')) {
+            url.chop(1);
+        }
+        if (url.isEmpty()) {
+            continue;
+        }
+        ServerStatus server;
+        server.baseUrl = url;
+        if (url == preferred) {
+            m_current = m_servers.size();
+        }
+        m_servers.append(server);
+    }
+}
+
+QString ServerSelector::current() const
+{
+    return m_servers.isEmpty() ? QString() : m_servers[m_current].baseUrl;
+}
+
+void ServerSelector::probe()
+{
+    // 上一轮还没有结束时不重复探测
+    if (m_servers.size() < 2 || !m_probing.isEmpty()) {
+        return;
+    }
+    for (int i = 0; i < m_servers.size(); ++i) {
+        QNetworkRequest request(QUrl(m_servers[i].baseUrl + "/system"));
+        request.setTransferTimeout(m_probeTimeoutMs);
+        request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+
+        QElapsedTimer timer;
+        timer.start();
+        QNetworkReply *reply = m_networkManager->get(request);
+        m_probing.insert(i);
+        connect(reply, &QNetworkReply::finished, this, [this, reply, i, timer]() {
+            onProbeFinished(reply, i, timer.elapsed());
+        });
+    }
+}
+
+void ServerSelector::onProbeFinished(QNetworkReply *reply, int index, qint64 elapsedMs)
+{
+    reply->deleteLater();
+    // 探测期间服务器列表被替换
+    if (!m_probing.remove(index) || index >= m_servers.size()) {
+        return;
+    }
+
+    ServerStatus& server = m_servers[index];
+    ++server.probes;
+    // 服务器有响应且不是5xx就认为可用，不要求登录
+    int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (httpStatus > 0 && httpStatus < 500) {
+        server.latencyMs = server.latencyMs < 0 ? elapsedMs : server.latencyMs * 0.7 + elapsedMs * 0.3;
+        server.consecutiveFailures = 0;
+        server.healthy = true;
+    } else {
+        ++server.probeFailures;
+        markFailed(server, 1);
+        qDebug() << "服务器探测失败:" << server.baseUrl << reply->errorString();
+    }
+
+    if (m_probing.isEmpty()) {
+        select();
+    }
+}
+
+void ServerSelector::reportSuccess(const QUrl& url)
+{
+    int index = indexOf(url);
+    if (index < 0) {
+        return;
+    }
+    m_servers[index].consecutiveFailures = 0;
+    m_servers[index].healthy = true;
+}
+
+void ServerSelector::reportFailure(const QUrl& url)
+{
+    int index = indexOf(url);
+    if (index < 0 || !m_servers[index].healthy) {
+        return;
+    }
+    markFailed(m_servers[index], RequestFailureThreshold);
+    if (index == m_current && !m_servers[index].healthy) {
+        select();
+        // 切换时用的是之前的探测结果，马上重新探测一次
+        probe();
+    }
+}
+
+void ServerSelector::markFailed(ServerStatus& server, int failureThreshold)
+{
+    if (++server.consecutiveFailures >= failureThreshold) {
+        server.healthy = false;
+    }
+}
+
+int ServerSelector::indexOf(const QUrl& url) const
+{
+    QString address = url.toString();
+    for (int i = 0; i < m_servers.size(); ++i) {
+        if (address.startsWith(m_servers[i].baseUrl + "/") || address == m_servers[i].baseUrl) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void ServerSelector::select()
+{
+    if (m_servers.size() < 2) {
+        return;
+    }
+
+    // 可用的服务器中延迟最低的，没有探测结果的排在后面并保持配置顺序
+    int best = -1;
+    for (int i = 0; i < m_servers.size(); ++i) {
+        const ServerStatus& server = m_servers[i];
+        if (!server.healthy) {
+            continue;
+        }
+        if (best < 0) {
+            best = i;
+            continue;
+        }
+        double bestLatency = m_servers[best].latencyMs;
+        if (server.latencyMs >= 0 && (bestLatency < 0 || server.latencyMs < bestLatency)) {
+            best = i;
+        }
+    }
+    // 全部不可用时保持不变，等下一次探测
+    if (best < 0 || best == m_current) {
+        return;
+    }
+
+    ServerStatus& current = m_servers[m_current];
+    if (current.healthy) {
+        if (current.latencyMs < 0 || m_servers[best].latencyMs < 0
+            || m_servers[best].latencyMs >= current.latencyMs * SwitchRatio) {
+            return;
+        }
+    } else {
+        ++current.failovers;
+    }
+
+    qDebug() << "选择服务器:" << m_servers[best].baseUrl << "延迟" << m_servers[best].latencyMs << "ms"
+             << "原服务器" << current.baseUrl << (current.healthy ? "较慢" : "不可用");
+    m_current = best;
+    emit currentChanged(m_servers[best].baseUrl);
+}
+
+QJsonObject ServerSelector::metrics() const
+{
+    QJsonArray servers;
+    for (int i = 0; i < m_servers.size(); ++i) {
+        const ServerStatus& server = m_servers[i];
+        servers.append(QJsonObject{
+            {"baseUrl", server.baseUrl},
+            {"latencyMs", server.latencyMs},
+            {"healthy", server.healthy},
+            {"probes", qint64(server.probes)},
+            {"probeFailures", qint64(server.probeFailures)},
+            {"failovers", qint64(server.failovers)},
+            {"current", i == m_current}
+        });
+    }
+    return QJsonObject{{"current", current()}, {"servers", servers}};
+}
@@ -0,0 +1,309 @@
+#include "submissionjournal.h"
+#include "functionlogger.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QJsonDocument>
+#include <QUuid>
+#include <QDateTime>
+#include <QDebug>
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+QList<int> PendingSubmission::pendingAttachments() const
+{
+    QList<int> indexes;
+    for (int i = 0; i < attachments.size(); ++i) {
+        QJsonObject attachment = attachments[i].toObject();
+        if (attachment["fileId"].toString().isEmpty() && !attachment["skipped"].toBool()) {
+            indexes.append(i);
+        }
+    }
+    return indexes;
+}
+
+QJsonObject PendingSubmission::requestBody() const
+{
+    QJsonObject body = request;
+    QJsonObject answer = body["answer"].toObject();
+
+    // 按服务器要求的格式合并上传题答案: {"questionId": {"subField": ["fileId"]}}
+    for (const QJsonValue& value : attachments) {
+        QJsonObject attachment = value.toObject();
+        QString fileId = attachment["fileId"].toString();
+        if (fileId.isEmpty()) {
+            continue;
+        }
+        QString field = attachment["field"].toString();
+        QString subField = attachment["subField"].toString();
+        QJsonObject fieldAnswer = answer[field].toObject();
+        QJsonArray files = fieldAnswer[subField].toArray();
+        files.append(fileId);
+        fieldAnswer[subField] = files;
+        answer[field] = fieldAnswer;
+    }
+
+    body["answer"] = answer;
+    return body;
+}
+
+SubmissionJournal::SubmissionJournal(const QString& filePath, QObject *parent)
+    : QObject(parent)
+    , m_filePath(filePath)
+{
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+}
+
+bool SubmissionJournal::load()
+{
+    FUNCTION_LOG();
+    m_entries.clear();
+    m_order.clear();
+    m_recordCount = 0;
+    m_partialTail = false;
+
+    QFile file(m_filePath);
+    if (!file.exists()) {
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "无法打开提交日志:" << m_filePath << file.errorString();
+        return false;
+    }
+
+    bool damaged = false;
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine();
+        // 写入过程中崩溃，最后一行没有换行符
+        m_partialTail = !line.endsWith('\n');
+        line = line.trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+        QJsonDocument doc = QJsonDocument::fromJson(line);
+        if (!doc.isObject()) {
+            // 写入过程中崩溃留下的半条记录
+            qWarning() << "忽略无法解析的提交日志记录:" << line.left(80);
+            damaged = true;
+            continue;
+        }
+        applyRecord(doc.object());
+        ++m_recordCount;
+    }
+    file.close();
+
+    qDebug() << "提交日志已恢复，待提交问卷:" << pendingCount() << "被拒绝:" << rejectedCount();
+    // 有损坏的记录时立即重写，否则之后追加的记录会接在半条记录后面，下次启动时一起被丢弃
+    if (damaged || m_partialTail) {
+        compact();
+    } else {
+        compactIfNeeded();
+    }
+    emit pendingCountChanged(pendingCount());
+    return true;
+}
+
+QString SubmissionJournal::append(const QString& projectId, const QJsonObject& request, const QJsonArray& attachments)
+{
+    FUNCTION_LOG();
+    QJsonObject record;
+    record["op"] = "add";
+    record["id"] = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    record["projectId"] = projectId;
+    record["request"] = request;
+    record["attachments"] = attachments;
+    record["createdAt"] = QDateTime::currentMSecsSinceEpoch();
+
+    if (!writeRecord(record)) {
+        return QString();
+    }
+    applyRecord(record);
+    emit pendingCountChanged(pendingCount());
+    return record["id"].toString();
+}
+
+bool SubmissionJournal::markAttachmentUploaded(const QString& id, int attachmentIndex, const QString& fileId)
+{
+    if (!m_entries.contains(id)) {
+        return false;
+    }
+    QJsonObject record{{"op", "attach"}, {"id", id}, {"index", attachmentIndex}, {"fileId", fileId}};
+    if (!writeRecord(record)) {
+        return false;
+    }
+    applyRecord(record);
+    return true;
+}
+
+bool SubmissionJournal::acknowledge(const QString& id)
+{
+    if (!m_entries.contains(id)) {
+        return false;
+    }
+    QJsonObject record{{"op", "ack"}, {"id", id}};
+    if (!writeRecord(record)) {
+        return false;
+    }
+    applyRecord(record);
+    compactIfNeeded();
+    emit pendingCountChanged(pendingCount());
+    return true;
+}
+
+bool SubmissionJournal::markRejected(const QString& id, const QString& reason)
+{
+    if (!m_entries.contains(id)) {
+        return false;
+    }
+    QJsonObject record{{"op", "reject"}, {"id", id}, {"reason", reason}};
+    if (!writeRecord(record)) {
+        return false;
+    }
+    applyRecord(record);
+    emit pendingCountChanged(pendingCount());
+    return true;
+}
+
+QStringList SubmissionJournal::pendingIds() const
+{
+    QStringList ids;
+    for (const QString& id : m_order) {
+        if (!m_entries[id].rejected) {
+            ids.append(id);
+        }
+    }
+    return ids;
+}
+
+const PendingSubmission *SubmissionJournal::entry(const QString& id) const
+{
+    auto it = m_entries.constFind(id);
+    return it != m_entries.constEnd() ? &it.value() : nullptr;
+}
+
+int SubmissionJournal::pendingCount() const
+{
+    int count = 0;
+    for (const PendingSubmission& submission : m_entries) {
+        if (!submission.rejected) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool SubmissionJournal::writeRecord(const QJsonObject& record)
+{
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "无法写入提交日志:" << m_filePath << file.errorString();
+        return false;
+    }
+    QByteArray line = QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n';
+    // 重写失败时文件仍以半条记录结尾，新记录另起一行
+    if (m_partialTail) {
+        line.prepend('\n');
+    }
+    if (file.write(line) != line.size() || !file.flush()) {
+        qWarning() << "写入提交日志失败:" << file.errorString();
+        // 可能只写入了一部分
+        m_partialTail = true;
+        return false;
+    }
+#ifdef Q_OS_UNIX
+    // 确认落盘后才返回，断电也不会丢失
+    ::fsync(file.handle());
+#endif
+    m_partialTail = false;
+    ++m_recordCount;
+    return true;
+}
+
+void SubmissionJournal::applyRecord(const QJsonObject& record)
+{
+    QString op = record["op"].toString();
+    QString id = record["id"].toString();
+
+    if (op == "add") {
+        PendingSubmission submission;
+        submission.id = id;
+        submission.projectId = record["projectId"].toString();
+        submission.request = record["request"].toObject();
+        submission.attachments = record["attachments"].toArray();
+        submission.createdAt = record["createdAt"].toVariant().toLongLong();
+        submission.rejected = record["rejected"].toBool();
+        submission.rejectReason = record["reason"].toString();
+        if (!m_entries.contains(id)) {
+            m_order.append(id);
+        }
+        m_entries.insert(id, submission);
+        return;
+    }
+
+    auto it = m_entries.find(id);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    if (op == "attach") {
+        int index = record["index"].toInt(-1);
+        if (index >= 0 && index < it->attachments.size()) {
+            QJsonObject attachment = it->attachments[index].toObject();
+            QString fileId = record["fileId"].toString();
+            if (fileId.isEmpty()) {
+                attachment["skipped"] = true; // 文件不存在或被服务器拒绝
+            } else {
+                attachment["fileId"] = fileId;
+            }
+            it->attachments[index] = attachment;
+        }
+    } else if (op == "ack") {
+        m_entries.erase(it);
+        m_order.removeOne(id);
+    } else if (op == "reject") {
+        it->rejected = true;
+        it->rejectReason = record["reason"].toString();
+    }
+}
+
+void SubmissionJournal::compactIfNeeded()
+{
+    // 过期记录不多时直接追加，避免频繁重写文件
+    if (m_recordCount <= qMax(32, int(m_entries.size()) * 2)) {
+        return;
+    }
+    compact();
+}
+
+void SubmissionJournal::compact()
+{
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "无法重写提交日志:" << file.errorString();
+        return;
+    }
+    for (const QString& id : m_order) {
+        const PendingSubmission& submission = m_entries[id];
+        QJsonObject record;
+        record["op"] = "add";
+        record["id"] = submission.id;
+        record["projectId"] = submission.projectId;
+        record["request"] = submission.request;
+        record["attachments"] = submission.attachments;
+        record["createdAt"] = submission.createdAt;
+        if (submission.rejected) {
+            record["rejected"] = true;
+            record["reason"] = submission.rejectReason;
+        }
+        file.write(QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n');
+    }
+    // 新文件完整写入后才替换旧文件
+    if (file.commit()) {
+        m_recordCount = m_order.size();
+        m_partialTail = false;
+    } else {
+        qWarning() << "重写提交日志失败:" << file.errorString();
+    }
+}
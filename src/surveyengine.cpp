@@ -0,0 +1,224 @@
+#include "surveyengine.h"
+
+QString SurveyNavigation::actionName(Action action)
+{
+    switch (action) {
+    case Stay: return "stay";
+    case Goto: return "goto";
+    case Submit: return "submit";
+    case RequiredMissing: return "requiredMissing";
+    case RuleRejected: return "ruleRejected";
+    }
+    return QString();
+}
+
+SurveyEngine::SurveyEngine(QObject *parent)
+    : QObject(parent)
+    , m_model(SurveyModelPtr::create())
+{
+    m_answers = new SurveyAnswerStore(this);
+    m_rules = new SurveyRuleEngine(m_answers, this);
+    m_rules->setOptionTitleLookup([this](const QString& questionId, const QString& optionId) {
+        return m_model->optionTitle(questionId, optionId);
+    });
+}
+
+void SurveyEngine::setModel(const SurveyModelPtr& model)
+{
+    m_model = model ? model : SurveyModelPtr::create();
+    m_rules->clear();
+    m_answers->clear();
+    m_currentIndex = 0;
+
+    // 预编译的逻辑规则交给规则引擎建立依赖索引
+    for (int i = 0; i < m_model->visibleCount(); ++i) {
+        m_rules->addQuestionRules(m_model->jumpRules()[i], m_model->finishRules()[i]);
+    }
+    for (const GlobalRule& globalRule : m_model->globalRules()) {
+        m_rules->addGlobalRule(globalRule);
+    }
+}
+
+void SurveyEngine::setCurrentIndex(int questionIndex)
+{
+    if (questionIndex >= 0 && questionIndex < m_model->visibleCount()) {
+        m_currentIndex = questionIndex;
+    }
+}
+
+bool SurveyEngine::setAnswer(const QString& questionId, const QJsonObject& answer)
+{
+    return m_answers->setAnswer(questionId, answer);
+}
+
+bool SurveyEngine::isRequired(int questionIndex) const
+{
+    if (questionIndex < 0 || questionIndex >= m_model->visibleCount()) {
+        return false;
+    }
+    return m_model->visibleQuestion(questionIndex).required;
+}
+
+bool SurveyEngine::isAnswered(int questionIndex) const
+{
+    if (questionIndex < 0 || questionIndex >= m_model->visibleCount()) {
+        return false;
+    }
+
+    const SurveyQuestion& question = m_model->visibleQuestion(questionIndex);
+    const QuestionType type = question.type;
+    QJsonObject answer = m_answers->answer(question.id);
+
+    // 根据题型检查是否已回答
+    if (type == QuestionType::FillBlank || type == QuestionType::Textarea) {
+        return !answer.isEmpty() && !answer.begin().value().toString().trimmed().isEmpty();
+    }
+    else if (type == QuestionType::Radio || type == QuestionType::Checkbox || type == QuestionType::Select) {
+        return !answer.isEmpty(); // 没有选中任何选项时答案为空
+    }
+    else if (type == QuestionType::MultipleBlank) {
+        for (const SurveyOption& blank : question.options) {
+            if (answer[blank.id].toString().trimmed().isEmpty()) {
+                return false; // 有任何一个子字段为空就不算完成
+            }
+        }
+        return true; // 所有子字段都已填写
+    }
+    else if (type == QuestionType::Score || type == QuestionType::Nps) {
+        // 评分题默认已回答（因为有默认值0）
+        return true;
+    }
+
+    // 其他类型默认返回true
+    return true;
+}
+
+int SurveyEngine::predictNextIndex(int questionIndex)
+{
+    // 规则结果由引擎缓存，只在其引用的题目答案变化后重新计算
+    // 如果表达式计算结果为true，跳转到 jump('questionId') 或 "条件 && 'questionId'" 指定的题目
+    if (m_rules->jumpRuleMatched(questionIndex)) {
+        // 跳转目标在编译问卷模型时已解析为题目下标
+        int targetIndex = m_model->jumpTargetIndex(questionIndex);
+        if (targetIndex >= 0 && targetIndex < m_model->visibleCount()) {
+            return targetIndex;
+        }
+        // 没有跳转目标时（如 "#{axq2}==#{axq2.feg4}"），条件满足也只跳转到下一题
+    }
+
+    // 默认返回下一题
+    return questionIndex + 1;
+}
+
+SurveyNavigation SurveyEngine::next()
+{
+    SurveyNavigation navigation;
+
+    // 检查当前题是否为必填题但未回答
+    if (isRequired(m_currentIndex) && !isAnswered(m_currentIndex)) {
+        navigation.action = SurveyNavigation::RequiredMissing;
+        navigation.targetIndex = m_currentIndex;
+        return navigation;
+    }
+
+    // 检查全局规则
+    for (int i = 0; i < m_rules->globalRuleCount(); ++i) {
+        const GlobalRule& rule = m_rules->globalRule(i);
+        if (rule.kind() == GlobalRule::Structured) {
+            // 条件不满足，继续检查其他全局规则
+            if (!m_rules->globalRuleResult(i)) {
+                continue;
+            }
+            // 跳转类型的全局规则不阻止翻页，只跳转到指定题目
+            // 条件通常取决于之前的答案，到达目标题后仍然满足，只向后跳转，否则在目标题上点击下一题会停在原地
+            for (const GlobalRuleAction& action : rule.actions()) {
+                if (action.type == GlobalRuleAction::Jump && action.questionIndex > m_currentIndex) {
+                    navigation.action = SurveyNavigation::Goto;
+                    navigation.targetIndex = action.questionIndex;
+                    m_currentIndex = action.questionIndex;
+                    return navigation;
+                }
+            }
+            continue;
+        }
+
+        // 表达式规则结果为false时阻止翻页
+        if (!m_rules->globalRuleResult(i)) {
+            navigation.action = SurveyNavigation::RuleRejected;
+            navigation.targetIndex = m_currentIndex;
+            return navigation;
+        }
+    }
+
+    // 满足结束规则时直接提交问卷
+    if (m_rules->finishRuleMatched(m_currentIndex)) {
+        navigation.action = SurveyNavigation::Submit;
+        return navigation;
+    }
+
+    int nextIndex = predictNextIndex(m_currentIndex);
+    if (nextIndex < m_model->visibleCount()) {
+        navigation.action = SurveyNavigation::Goto;
+        navigation.targetIndex = nextIndex;
+        m_currentIndex = nextIndex;
+    }
+    return navigation;
+}
+
+SurveyNavigation SurveyEngine::previous()
+{
+    SurveyNavigation navigation;
+    if (m_currentIndex > 0) {
+        navigation.action = SurveyNavigation::Goto;
+        navigation.targetIndex = --m_currentIndex;
+    }
+    return navigation;
+}
+
+SurveyNavigation SurveyEngine::submit()
+{
+    SurveyNavigation navigation;
+    if (isRequired(m_currentIndex) && !isAnswered(m_currentIndex)) {
+        navigation.action = SurveyNavigation::RequiredMissing;
+        navigation.targetIndex = m_currentIndex;
+        return navigation;
+    }
+    navigation.action = SurveyNavigation::Submit;
+    return navigation;
+}
+
+QJsonObject SurveyEngine::submitPayload(const UploadJobTable *uploads, const QString& location) const
+{
+    // 各题答案已写入答案存储
+    QJsonObject answers = m_answers->toJson();
+
+    // 选项文字可以由问卷结构得到，不需要随答案重复上传
+    if (m_compactChoiceAnswers) {
+        for (auto it = answers.begin(); it != answers.end(); ++it) {
+            const SurveyQuestion *question = m_model->question(it.key());
+            if (!question || (question->type != QuestionType::Radio && question->type != QuestionType::Checkbox)) {
+                continue;
+            }
+            // 带填空的选项值是对象，保留原样
+            QJsonObject answer = it.value().toObject();
+            for (auto option = answer.begin(); option != answer.end(); ++option) {
+                if (option.value().isString()) {
+                    option.value() = option.key();
+                }
+            }
+            it.value() = answer;
+        }
+    }
+
+    // 上传题的答案由上传任务表直接写入
+    if (uploads) {
+        uploads->applyToAnswers(answers);
+    }
+
+    if (const SurveyQuestion *locationQuestion = m_model->locationQuestion()) {
+        QString optionId = locationQuestion->options.isEmpty() ? QString() : locationQuestion->options.first().id;
+        answers[locationQuestion->id] = QJsonObject{{optionId, location}};
+    }
+
+    return answers;
+}
@@ -19,7 +19,6 @@
 #include <QFileInfo>
 #include <QStackedWidget>
 #include <QHBoxLayout>
-#include <QRegularExpression>
 #include <QProgressBar>
 #include <QSettings>
 #include <QPermissions>
@@ -33,6 +32,35 @@ SurveyFormWidget::SurveyFormWidget(QWidget *parent) : QWidget(parent)
     FUNCTION_LOG();
     m_stackedWidget = new CustomStackedWidget(this);
     m_currentQuestionIndex = 0;
+    m_model = SurveyModelPtr::create();
+    // 答案、逻辑规则和翻页决策由不依赖界面的问卷引擎负责
+    m_engine = new SurveyEngine(this);
+    // 只写选项id会改变服务器上保存的答案格式，默认保持附带选项文字
+    m_engine->setCompactChoiceAnswers(SettingsManager::getInstance().getValue("survey/compactChoiceAnswers", false).toBool());
+
+    // 题目控件按题型复用，新建控件时连接作答和上传信号
+    m_viewPool = new QuestionViewPool(this);
+    connect(m_viewPool, &QuestionViewPool::viewCreated, this, [this](QuestionView *view) {
+        connect(view, &QuestionView::answerEdited, this, [this, view]() {
+            // 评分题等在绑定时写入的默认答案不算作答
+            if (!m_isRestoring) {
+                m_userEdited = true;
+            }
+            onAnswerEdited(m_pageHost->indexOfView(view));
+        });
+        if (UploadQuestionView *uploadView = qobject_cast<UploadQuestionView*>(view)) {
+            connect(uploadView, &UploadQuestionView::uploadRequested, this, &SurveyFormWidget::handleUploadButton);
+        }
+    });
+
+    // 只保留少量页面槽位，题目页面在显示时才绑定
+    m_pageHost = new QuestionPageHost(m_stackedWidget, m_viewPool, 3, this);
+
+    // 作答停顿后再预测下一题，避免每次输入都重新构建页面
+    m_prefetchTimer = new QTimer(this);
+    m_prefetchTimer->setSingleShot(true);
+    m_prefetchTimer->setInterval(50);
+    connect(m_prefetchTimer, &QTimer::timeout, this, &SurveyFormWidget::prefetchNextPage);
     
     // 创建主布局
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
@@ -136,7 +164,7 @@ SurveyFormWidget::SurveyFormWidget(QWidget *parent) : QWidget(parent)
     connect(m_captureTimer, &QTimer::timeout, this, &SurveyFormWidget::capturePhoto);
 }
 
-void SurveyFormWidget::handleUploadButton(QPushButton* uploadButton, const QString& field)
+void SurveyFormWidget::handleUploadButton(const QString& field)
 {
     FUNCTION_LOG();
     // 打开文件选择对话框，支持图片和视频
@@ -144,629 +172,175 @@ void SurveyFormWidget::handleUploadButton(QPushButton* uploadButton, const QStri
     QString filePath = QFileDialog::getOpenFileName(this, "选择文件", "", filter);
     
     if (!filePath.isEmpty()) {
+        m_userEdited = true;
         // 保存选中的文件路径
-        AddFile(field, filePath);
+        quint64 requestId = AddFile(field, filePath);
         
         // 更新文件列表标签
         QFileInfo fileInfo(filePath);
         QString fileName = fileInfo.fileName();
         QString fileSize = QString::number(fileInfo.size() / 1024.0, 'f', 1) + " KB";
         
-        if (m_fileLabels.contains(field)) {
-            m_fileLabels[field]->setText(QString("已选择文件：%1 (%2)").arg(fileName, fileSize));
+        for (QuestionView *view : m_pageHost->liveViews()) {
+            UploadQuestionView *uploadView = qobject_cast<UploadQuestionView*>(view);
+            if (uploadView && uploadView->questionId() == field) {
+                uploadView->setFileText(QString("已选择文件：%1 (%2)").arg(fileName, fileSize));
+            }
         }
         
         // 立即上传文件
-        // NetworkManager::instance().uploadFile(m_schema["id"].toString(), field, filePath);
-        emit UploadFile(m_schema["id"].toString(), field, filePath);
+        // NetworkManager::instance().uploadFile(m_model->id(), field, filePath);
+        emit UploadFile(requestId, m_model->id(), field, filePath, UploadPriority::UserFile);
     }
 }
 
-void SurveyFormWidget::setSurveySchema(const QJsonObject& schema)
+void SurveyFormWidget::setSurveyModel(const SurveyModelPtr& model)
 {
     FUNCTION_LOG();
-    m_schema = schema;
-    renderSurvey(schema);
-
+    m_model = model ? model : SurveyModelPtr::create();
+    renderSurvey();
+    // 先显示缓存、后台确认后结构有变化时会再次调用，只重新绑定页面；
+    // 答题计时、定位、录音和拍照只在第一次显示题目时开始，否则录音文件会被覆盖
+    if (!m_sessionStarted && m_model->visibleCount() > 0) {
+        m_sessionStarted = true;
+        startSession();
+    }
+}
 
+bool SurveyFormWidget::hasUserEdits() const
+{
+    return m_userEdited;
 }
 
-void SurveyFormWidget::handleUploadSuccsee(const QJsonObject &response)
+void SurveyFormWidget::handleUploadSuccsee(quint64 requestId, const QJsonObject &response)
 {
     FUNCTION_LOG();
-    qDebug()<<"handleUploadSuccsee.....";
-    QString field,subField;
-    QString fileName = response["data"].toObject()["originalName"].toString();
-    qDebug()<<fileName;
-    for(int i=0;i<m_selectedFiles.size();i++)
-    {
-        QJsonObject obj = m_selectedFiles[i].toObject();
-        QJsonObject::iterator it;
-        for (it = obj.begin(); it != obj.end(); ++it) {
-            QString key = it.key();
-            QJsonValue value = it.value();
-            if(value.toString().contains(fileName))
-            {
-                field = key;
-                m_selectedFiles.removeAt(i);
-                break;
-            }
-        }
-    }
-    for(int i=0;i<m_questions.size();i++)
-    {
-        if(m_questions[i]["id"].toString() == field)
-        {
-            QJsonArray array = m_questions[i]["children"].toArray();
-            for(int j=0;j<array.size();j++)
-            {
-                if(array[j].toObject().contains("id"))
-                {
-                    subField = array[j].toObject()["id"].toString();
-                }
-            }
-            break;
-        }
-
-    }
-    // 从响应中提取文件信息并保存
-    if (!field.isEmpty()) {
-        QJsonObject obj = response["data"].toObject();
-        obj["subField"] = subField;
-        obj["field"] = field;
-        m_uploadedFiles.append(obj);
-        qDebug()<<"success:"<<m_uploadedFiles;
-        // QMessageBox::information(this, "上传成功", "文件上传成功");
-        // 减少待上传计数
-        m_pendingUploads--;
-        // 如果所有文件都已上传完成，则更新上传状态
-        if (m_pendingUploads <= 0) {
-            m_isUploading = false;
-            m_pendingUploads = 0; // 确保不会出现负数
-
-            // 如果之前有提交请求被阻止，则现在执行提交
-            if (m_shouldSubmitAfterUpload) {
-                m_shouldSubmitAfterUpload = false;
-                emit submitSurvey(collectAnswers());
-            }
-        }
-    }
+    // 按请求id找到上传任务，其他表单发起的上传直接忽略
+    QString fileId = response["data"].toObject()["id"].toString();
+    m_uploadJobs.markUploaded(requestId, fileId);
+    // QMessageBox::information(this, "上传成功", "文件上传成功");
 }
 
-void SurveyFormWidget::handleUploadFailed(const QString& error)
+void SurveyFormWidget::handleUploadFailed(quint64 requestId, const QString& error)
 {
     FUNCTION_LOG();
+    if (!m_uploadJobs.markFailed(requestId)) {
+        return;
+    }
+    // 失败的文件提交时交给提交队列补传
     QMessageBox::warning(this, "上传失败", "文件上传失败: " + error);
-    // 减少待上传计数
-    m_pendingUploads--;
-    // 如果所有文件都已上传完成，则更新上传状态
-    if (m_pendingUploads <= 0) {
-        m_isUploading = false;
-        m_pendingUploads = 0; // 确保不会出现负数
-
-        // 如果之前有提交请求被阻止，则现在执行提交
-        if (m_shouldSubmitAfterUpload) {
-            m_shouldSubmitAfterUpload = false;
-            emit submitSurvey(collectAnswers());
+}
+
+void SurveyFormWidget::handleUploadProgress(quint64 requestId, qint64 bytesSent, qint64 bytesTotal)
+{
+    if (bytesTotal <= 0 || !m_uploadJobs.setProgress(requestId, bytesSent, bytesTotal)) {
+        return;
+    }
+    // 只有用户选择的文件在当前页面上显示进度
+    const UploadJob *job = m_uploadJobs.job(requestId);
+    for (QuestionView *view : m_pageHost->liveViews()) {
+        UploadQuestionView *uploadView = qobject_cast<UploadQuestionView*>(view);
+        if (uploadView && uploadView->questionId() == job->questionId) {
+            uploadView->setFileText(QString("正在上传：%1 (%2%)").arg(QFileInfo(job->path).fileName())
+                                        .arg(bytesSent * 100 / bytesTotal));
         }
     }
 }
 
-void SurveyFormWidget::renderSurvey(const QJsonObject& schema)
+void SurveyFormWidget::renderSurvey()
 {
     FUNCTION_LOG();
-    m_startTime = QDateTime::currentMSecsSinceEpoch();
+    // 回收所有页面，页面槽位数量固定，不随题目数量增长
+    m_prefetchTimer->stop();
+    m_prefetchIndex = -1;
+    m_pageHost->reset(m_model);
+    m_engine->setModel(m_model);
 
-    LocationManager::instance().startContinuousLocationUpdates(30000);
-    
-    // 清除之前的内容
-    while (m_stackedWidget->count() > 0) {
-        QWidget *widget = m_stackedWidget->widget(0);
-        m_stackedWidget->removeWidget(widget);
-        delete widget;
-    }
-    
-    m_questionPages.clear();
-    m_questions.clear();
-    m_showQuestions.clear();
-
-
-    // 解析并显示问卷标题 (SurveyKing中问卷标题在survey.title字段)
-    QJsonObject survey = schema["survey"].toObject();
-    QString title = survey["title"].toString();
-
-    // 清空标题区域内容
-    // QLayout *titleLayout = m_scrollWidget->layout();
-    // if (titleLayout) {
-    //     QLayoutItem *item;
-    //     while ((item = titleLayout->takeAt(0)) != 0) {
-    //         delete item->widget();
-    //         delete item;
-    //     }
-    // } else {
-    //     titleLayout = new QVBoxLayout(m_scrollWidget);
-    //     titleLayout->setContentsMargins(5, 5, 5, 5);
-    //     titleLayout->setSpacing(3);
-    // }
-
-    // QLabel *titleLabel = new QLabel(title);
-    // QFont titleFont("Microsoft YaHei", 30, QFont::Bold);
-    // titleLabel->setFont(titleFont);
-    // titleLabel->setWordWrap(true);
-    // titleLabel->setAlignment(Qt::AlignCenter);
-
-    // titleLayout->addWidget(titleLabel);
-
-    m_titleLabel->setText(title);
-
-    // 解析并显示问卷描述
-    QString description = survey["description"].toString();
+    // 问卷模型已在网络线程中编译好，这里只负责界面
+    m_titleLabel->setText(m_model->title());
+
+    // 显示问卷描述
+    QString description = m_model->description();
     if (!description.isEmpty()) {
         m_descLabel->setText(description);
     }
-    
-    // 发射开始答题信号
-    emit startSurvey();
-
-    m_showNum = 0;
-    // 解析题目 (SurveyKing中问题结构在survey.children字段中)
-    QJsonArray questions = survey["children"].toArray();
-    for (int i = 0; i < questions.size(); ++i) {
-        QJsonObject question = questions[i].toObject();
-        m_questions.append(question);
-
-        // 检查题目是否应该隐藏
-        QJsonObject attribute = question["attribute"].toObject();
-        bool isHidden = false;
-        // 检查 display 属性
-        if (attribute.contains("display") && attribute["display"].isString()) {
-            QString displayValue = attribute["display"].toString();
-            if (displayValue == "hidden") {
-                isHidden = true;
-            }
-        }
-
-        // 只有非隐藏题目才添加到问卷中
-        if (!isHidden) {
-            m_showQuestions.append(question);
-            m_showNum++;
-        }
 
-        QString title = question["title"].toString();
-        // 保存自动上传相关的隐藏题目
-        if(title == "录音和拍摄文件" && isHidden)
-            m_autoUpLoadObj = question;
-        else if(title == "位置信息" && isHidden)
-            m_locationObj = question;
-    }
-
-    // 处理全局规则
-    QJsonObject surveyAttribute = survey["attribute"].toObject();
-    if (surveyAttribute.contains("globalRule") && surveyAttribute["globalRule"].isArray()) {
-        QJsonArray globalRules = surveyAttribute["globalRule"].toArray();
-        for (int i = 0; i < globalRules.size(); ++i) {
-            QString rule = globalRules[i].toString();
-            m_globalRules.append(rule);
-        }
-    }
-
-    // 为每道题创建页面
-    for (int i = 0; i < m_showQuestions.size(); ++i) {
+    m_showNum = m_model->visibleCount();
 
-        QWidget *page = new QWidget;
-        QVBoxLayout *pageLayout = new QVBoxLayout(page);
-        pageLayout->setContentsMargins(0, 0, 0, 0);
-        m_questionPages.append(page);
-        m_stackedWidget->addWidget(page);
-    }
-    
     // 如果有题目，则显示第一题
-    if (!m_showQuestions.isEmpty()) {
+    if (m_model->visibleCount() > 0) {
         m_currentQuestionIndex = 0;
         renderQuestionPage(0);
-        m_stackedWidget->setCurrentIndex(0);
         updateProgress(m_showNum); // 初始化进度条
         m_scrollArea->verticalScrollBar()->setValue(0);
 
         // 更新按钮状态
         m_prevButton->setEnabled(false);
         m_nextButton->setVisible(true);
-        m_submitButton->setVisible(m_showQuestions.size() <= 1);
+        m_submitButton->setVisible(m_model->visibleCount() <= 1);
         
-        if (m_showQuestions.size() <= 1) {
+        if (m_model->visibleCount() <= 1) {
             m_nextButton->setVisible(false);
             m_submitButton->setVisible(true);
         } else {
             m_nextButton->setVisible(true);
             m_submitButton->setVisible(false);
         }
-
-        // 是否有录音
-        if(SettingsManager::getInstance().getValue("survey/autoRecord").toBool())
-        {
-            requestAudioPermission();
-        }
-
-        // 检查是否启用自动拍照
-        m_autoCaptureEnabled = SettingsManager::getInstance().getValue("survey/autoCapture", false).toBool();
-        if (m_autoCaptureEnabled) {
-            initCamera();
-        }
     }
     
     // 设置StackedWidget的尺寸策略，确保它能正确填充可用空间
     m_stackedWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 }
 
-void SurveyFormWidget::renderQuestionPage(int questionIndex)
+void SurveyFormWidget::startSession()
 {
     FUNCTION_LOG();
-    if (questionIndex < 0 || questionIndex >= m_showQuestions.size()) {
-        return;
-    }
-    
-    // 获取当前页面
-    QWidget *page = m_questionPages[questionIndex];
-    QVBoxLayout *pageLayout = qobject_cast<QVBoxLayout*>(page->layout());
-    
-    // 清除页面内容（保留布局）
-    QLayoutItem *item;
-    while ((item = pageLayout->takeAt(0)) != nullptr) {
-        delete item->widget();
-        delete item;
-    }
+    m_startTime = QDateTime::currentMSecsSinceEpoch();
 
-    
-    // 获取题目信息
-    QJsonObject question = m_showQuestions[questionIndex];
-    QString type = question["type"].toString();
-    QString title = question["title"].toString();
-    QString field = question["id"].toString();
-    QJsonObject attribute = question["attribute"].toObject();
-    bool isRequired = attribute["required"].toBool();
-    QString description = question["description"].toString(); // 获取题目描述
-
-    QGroupBox *questionGroup = new QGroupBox;
-    questionGroup->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::MinimumExpanding);
-
-    QVBoxLayout *questionLayout = new QVBoxLayout(questionGroup);
-    questionLayout->setSpacing(12);
-
-    QString questionText = QString("<html><body><p style='font-size:16px; font-weight:bold; margin:0; color:#2c3e50;'>%1%2</p></body></html>")
-                          .arg(title)
-                          .arg(isRequired ? "<span style='color:#e74c3c;'> *</span>" : "");
-
-    QLabel *questionLabel = new QLabel(questionText);
-    questionLabel->setWordWrap(true);
-    questionLabel->setTextFormat(Qt::RichText);
-    questionLayout->addWidget(questionLabel);
-
-    // 如果有题目描述，则显示题目描述
-    if (!description.isEmpty()) {
-        QLabel *descriptionLabel = new QLabel(description);
-        descriptionLabel->setWordWrap(true);
-        questionLayout->addWidget(descriptionLabel);
-    }
+    LocationManager::instance().startContinuousLocationUpdates(30000);
 
-    // 根据题型创建不同的输入控件
-    if (type == "FillBlank") {
-        QLineEdit *lineEdit = new QLineEdit;
-        lineEdit->setProperty("field", field);
-        QJsonArray options = question["children"].toArray();
-        for (int j = 0; j < options.size(); ++j) {
-            QJsonObject option = options[j].toObject();
-            QString optionId = option["id"].toString();
-            lineEdit->setProperty("id", optionId);
-        }
+    // 发射开始答题信号
+    emit startSurvey();
 
-        questionLayout->addWidget(lineEdit);
-    }
-    else if (type == "Textarea") {
-        QTextEdit *textEdit = new QTextEdit;
-        textEdit->setProperty("field", field);
-        QJsonArray options = question["children"].toArray();
-        for (int j = 0; j < options.size(); ++j) {
-            QJsonObject option = options[j].toObject();
-            QString optionId = option["id"].toString();
-            textEdit->setProperty("id", optionId);
-        }
-        textEdit->setMaximumHeight(150);
-        questionLayout->addWidget(textEdit);
+    // 是否有录音
+    if(SettingsManager::getInstance().getValue("survey/autoRecord").toBool())
+    {
+        requestAudioPermission();
     }
-    else if (type == "Radio") {
-        QButtonGroup *buttonGroup = new QButtonGroup(questionGroup);
-        buttonGroup->setExclusive(true);
-        buttonGroup->setProperty("field", field);
-
-        QJsonArray options = question["children"].toArray();
-        QVBoxLayout *optionsLayout = new QVBoxLayout;
-        optionsLayout->setSpacing(10);
-
-        for (int j = 0; j < options.size(); ++j) {
-            QJsonObject option = options[j].toObject();
-            QString optionText = option["title"].toString();
-            QString optionId = option["id"].toString();
-            
-            // 检查选项是否包含填空
-            QJsonObject optionAttribute = option["attribute"].toObject();
-            bool hasBlank = optionAttribute["dataType"].toString() == "horzBlank";
-
-            if (hasBlank) {
-                // 创建包含输入框的选项布局
-                QHBoxLayout *optionLayout = new QHBoxLayout;
-                
-                QRadioButton *radioButton = new QRadioButton;
-                radioButton->setProperty("field", field);
-                radioButton->setProperty("value", optionId);
-                // 提取下划线前的文本作为标签
-                QString label = optionText;
-                label.replace("____________", "");
-                QLabel *optionLabel = new QLabel(label);
-                
-                QLineEdit *lineEdit = new QLineEdit;
-                // 示例：设置下划线样式
-                lineEdit->setProperty("field", field);
-                QJsonArray chi = option["children"].toArray();
-                QString sub = chi.at(0)["id"].toString();
-                lineEdit->setProperty("subField", optionId);
-                lineEdit->setProperty("id", sub);
-                lineEdit->setPlaceholderText("请输入");
-                lineEdit->setEnabled(false); // 默认禁用，选中单选按钮后启用
-                
-                // 连接单选按钮和输入框的状态
-                connect(radioButton, &QRadioButton::toggled, [lineEdit](bool checked) {
-                    lineEdit->setEnabled(checked);
-                    if (!checked) {
-                        lineEdit->clear();
-                    }
-                });
-                
-                optionLayout->addWidget(radioButton);
-                optionLayout->addWidget(optionLabel);
-                optionLayout->addWidget(lineEdit);
-                optionLayout->addStretch();
-                
-                optionsLayout->addLayout(optionLayout);
-                buttonGroup->addButton(radioButton, j);
-            } else {
-                // 普通选项
-                QRadioButton *radioButton = new QRadioButton(optionText);
-                radioButton->setProperty("field", field);
-                radioButton->setProperty("value", optionId);
-                buttonGroup->addButton(radioButton, j);
-                optionsLayout->addWidget(radioButton);
-            }
-        }
 
-        questionLayout->addLayout(optionsLayout);
+    // 检查是否启用自动拍照
+    m_autoCaptureEnabled = SettingsManager::getInstance().getValue("survey/autoCapture", false).toBool();
+    if (m_autoCaptureEnabled) {
+        initCamera();
     }
-    else if (type == "Checkbox") {
-        QButtonGroup *buttonGroup = new QButtonGroup(questionGroup);
-        buttonGroup->setExclusive(false);  // 设置为非独占，允许多选
-        buttonGroup->setProperty("field", field);
-
-        QJsonArray options = question["children"].toArray();
-        QVBoxLayout *optionsLayout = new QVBoxLayout;
-        optionsLayout->setSpacing(10);
-
-        for (int j = 0; j < options.size(); ++j) {
-            QJsonObject option = options[j].toObject();
-            QString optionText = option["title"].toString();
-            QString optionId = option["id"].toString();
-            
-            // 检查选项是否包含填空
-            QJsonObject optionAttribute = option["attribute"].toObject();
-            bool hasBlank = optionAttribute["dataType"].toString() == "horzBlank";
-
-            if (hasBlank) {
-                // 创建包含输入框的选项布局
-                QHBoxLayout *optionLayout = new QHBoxLayout;
-                
-                QCheckBox *checkBox = new QCheckBox;
-                checkBox->setProperty("field", field);
-                checkBox->setProperty("value", optionId);
-                
-                // 提取下划线前的文本作为标签
-                QString label = optionText;
-                label.replace("____________", "");
-                QLabel *optionLabel = new QLabel(label);
-                
-                QLineEdit *lineEdit = new QLineEdit;
-                lineEdit->setProperty("field", field);
-                lineEdit->setProperty("subField", optionId);
-                lineEdit->setPlaceholderText("请输入");
-                lineEdit->setEnabled(false); // 默认禁用，选中复选框后启用
-                
-                // 连接复选框和输入框的状态
-                connect(checkBox, &QCheckBox::toggled, [lineEdit](bool checked) {
-                    lineEdit->setEnabled(checked);
-                    if (!checked) {
-                        lineEdit->clear();
-                    }
-                });
-                
-                optionLayout->addWidget(checkBox);
-                optionLayout->addWidget(optionLabel);
-                optionLayout->addWidget(lineEdit);
-                optionLayout->addStretch();
-                
-                optionsLayout->addLayout(optionLayout);
-                buttonGroup->addButton(checkBox, j);
-            } else {
-                // 普通选项
-                QCheckBox *checkBox = new QCheckBox(optionText);
-                checkBox->setProperty("field", field);
-                checkBox->setProperty("value", optionId);
-                buttonGroup->addButton(checkBox, j);
-                optionsLayout->addWidget(checkBox);
-            }
-        }
+}
 
-        questionLayout->addLayout(optionsLayout);
-    }
-    else if (type == "Select") {
-        QComboBox *comboBox = new QComboBox;
-        comboBox->setProperty("field", field);
-        
-        // 添加空选项作为默认选项
-        comboBox->addItem("请选择");
-        
-        QJsonArray options = question["children"].toArray();
-        for (int j = 0; j < options.size(); ++j) {
-            QJsonObject option = options[j].toObject();
-            QString optionText = option["title"].toString();
-            QString optionId = option["id"].toString();
-            comboBox->addItem(optionText, optionId);
-        }
-        
-        questionLayout->addWidget(comboBox);
-    }
-    else if (type == "MultipleBlank") {
-        QJsonArray blanks = question["children"].toArray();
-        for (int j = 0; j < blanks.size(); ++j) {
-            QJsonObject blank = blanks[j].toObject();
-            QString blankTitle = blank["title"].toString();
-            QString blankId = blank["id"].toString();
-            
-            QHBoxLayout *blankLayout = new QHBoxLayout;
-            QLabel *blankLabel = new QLabel(blankTitle + ":");
-            QLineEdit *lineEdit = new QLineEdit;
-            lineEdit->setProperty("field", field);
-            lineEdit->setProperty("subField", blankId);
-            
-            blankLayout->addWidget(blankLabel);
-            blankLayout->addWidget(lineEdit);
-            questionLayout->addLayout(blankLayout);
-        }
-    }
-    else if (type == "Score" || type == "Nps") {
-        // 评分题和NPS题 - 使用滑块
-        QVBoxLayout *scoreLayout = new QVBoxLayout;
-        
-        QSlider *slider = new QSlider(Qt::Horizontal);
-        slider->setRange(0, 10);
-        slider->setValue(0);
-        slider->setTickPosition(QSlider::TicksBelow);
-        slider->setTickInterval(1);
-        slider->setProperty("field", field);
-        
-        QHBoxLayout *scoreLabelsLayout = new QHBoxLayout;
-        for (int i = 0; i <= 10; ++i) {
-            QLabel *label = new QLabel(QString::number(i));
-            label->setAlignment(Qt::AlignCenter);
-            scoreLabelsLayout->addWidget(label);
-        }
-        
-        scoreLayout->addWidget(slider);
-        scoreLayout->addLayout(scoreLabelsLayout);
-        questionLayout->addLayout(scoreLayout);
-    }
-    else if (type == "Cascader") {
-        // 级联题 - 添加级联选择器
-        QVBoxLayout *cascaderLayout = new QVBoxLayout;
-        
-        QComboBox *firstLevelCombo = new QComboBox;
-        firstLevelCombo->addItem("请选择");
-        firstLevelCombo->setProperty("field", field);
-        
-        QComboBox *secondLevelCombo = new QComboBox;
-        secondLevelCombo->addItem("请选择");
-        secondLevelCombo->setEnabled(false);
-        
-        cascaderLayout->addWidget(firstLevelCombo);
-        cascaderLayout->addWidget(secondLevelCombo);
-        
-        // 添加示例选项
-        firstLevelCombo->addItem("选项1", "opt1");
-        firstLevelCombo->addItem("选项2", "opt2");
-        
-        // 连接级联逻辑
-        connect(firstLevelCombo, &QComboBox::currentTextChanged, [secondLevelCombo](const QString &text) {
-            secondLevelCombo->clear();
-            secondLevelCombo->addItem("请选择");
-            if (!text.isEmpty() && text != "请选择") {
-                secondLevelCombo->setEnabled(true);
-                secondLevelCombo->addItem("子选项1", "sub1");
-                secondLevelCombo->addItem("子选项2", "sub2");
-            } else {
-                secondLevelCombo->setEnabled(false);
-            }
-        });
-        
-        questionLayout->addLayout(cascaderLayout);
-    }
-    else if (type == "Upload") {
-        // 上传题 - 添加文件选择按钮
-        QVBoxLayout *uploadLayout = new QVBoxLayout;
-        
-        QPushButton *uploadButton = new QPushButton("选择文件");
-        uploadButton->setProperty("field", field);
-        
-        QLabel *fileListLabel = new QLabel("已选择文件：无");
-        fileListLabel->setWordWrap(true);
-        
-        // 保存引用以便后续更新
-        m_fileLabels[field] = fileListLabel;
-        
-        uploadLayout->addWidget(uploadButton);
-        uploadLayout->addWidget(fileListLabel);
-        
-        questionLayout->addLayout(uploadLayout);
-        
-        // 连接上传按钮点击事件
-        connect(uploadButton, &QPushButton::clicked, [=]() {
-            handleUploadButton(uploadButton, field);
-        });
-    }
-    else if (type == "Signature") {
-        // 电子签名 - 添加签名区域
-        QVBoxLayout *signatureLayout = new QVBoxLayout;
-        
-        QLabel *signatureLabel = new QLabel("请在下方区域签名（模拟实现）");
-        
-        // 签名显示区域
-        QLabel *signatureArea = new QLabel("签名区域");
-        signatureArea->setAlignment(Qt::AlignCenter);
-        signatureArea->setMinimumHeight(100);
-        signatureArea->setProperty("field", field);
-        
-        QHBoxLayout *signatureButtonsLayout = new QHBoxLayout;
-        QPushButton *signButton = new QPushButton("签名");
-        
-        QPushButton *clearButton = new QPushButton("清除");
-        
-        signatureButtonsLayout->addWidget(signButton);
-        signatureButtonsLayout->addWidget(clearButton);
-        signatureButtonsLayout->addStretch();
-        
-        signatureLayout->addWidget(signatureLabel);
-        signatureLayout->addWidget(signatureArea);
-        signatureLayout->addLayout(signatureButtonsLayout);
-        
-        questionLayout->addLayout(signatureLayout);
-    }
-    else if (type == "Barcode") {
-        // 扫码题 - 添加扫码按钮
-        QVBoxLayout *barcodeLayout = new QVBoxLayout;
-        
-        QPushButton *scanButton = new QPushButton("扫描二维码");
-        barcodeLayout->addWidget(scanButton);
-        
-        QLabel *barcodeResult = new QLabel("扫描结果将显示在这里");
-        barcodeResult->setWordWrap(true);
-        barcodeLayout->addWidget(barcodeResult);
-        
-        questionLayout->addLayout(barcodeLayout);
+void SurveyFormWidget::renderQuestionPage(int questionIndex)
+{
+    FUNCTION_LOG();
+    if (questionIndex < 0 || questionIndex >= m_model->visibleCount()) {
+        return;
     }
-    else {
-        // 默认处理 - 简单文本输入
-        QLineEdit *lineEdit = new QLineEdit;
-        lineEdit->setProperty("field", field);
-        questionLayout->addWidget(lineEdit);
+
+    // 页面只在需要显示时才占用槽位，绑定过程中的变化信号不回写答案存储
+    m_isRestoring = true;
+    QuestionView *view = m_pageHost->materialize(questionIndex);
+    m_isRestoring = false;
+    if (!view) {
+        return;
     }
-    
-    pageLayout->addWidget(questionGroup);
-    pageLayout->addStretch();
+
+    // 从答案存储恢复已作答内容，控件的变化由answerEdited信号写回答案存储
+    restoreAnswer(questionIndex);
+    onAnswerEdited(questionIndex);
+
+    m_pageHost->show(questionIndex);
+    // 只保留当前页和上一页，预测的下一页在空闲时重新构建
+    m_prefetchIndex = -1;
+    m_pageHost->retain({questionIndex - 1, questionIndex});
+
+    QWidget *page = m_pageHost->page(questionIndex);
+    QVBoxLayout *pageLayout = qobject_cast<QVBoxLayout*>(page->layout());
 
     // 在页面渲染完成后，强制计算尺寸
     page->setMinimumHeight(0); // 清除最小高度限制
@@ -787,446 +361,130 @@ void SurveyFormWidget::renderQuestionPage(int questionIndex)
             updateScrollBarVisibility();
         }
     });
+
+    schedulePrefetch();
 }
 
 void SurveyFormWidget::onNextClicked()
 {
     FUNCTION_LOG();
-    // 保存当前题目的答案
-    saveCurrentAnswer(m_currentQuestionIndex);
-
-    // 检查当前题是否为必填题但未回答
-    if (isQuestionRequired(m_currentQuestionIndex) && !isQuestionAnswered(m_currentQuestionIndex)) {
+    // 必答、全局规则、结束规则和跳转规则的判断由问卷引擎完成
+    SurveyNavigation navigation = m_engine->next();
+    switch (navigation.action) {
+    case SurveyNavigation::RequiredMissing:
         QMessageBox::warning(this, "提示", "这是必填题，请完成作答后再继续");
-        return;
-    }
-
-    // 检查全局规则
-    if (!evaluateGlobalRules()) {
-        // 如果全局规则检查失败，不继续执行
-        return;
-    }
-    
-    // 检查是否有结束规则
-    if (evaluateFinishRule(m_currentQuestionIndex)) {
+        break;
+    case SurveyNavigation::Submit:
         // 如果满足结束规则，直接提交问卷
         onSubmitClicked();
-        return;
-    }
-    
-    int nextIndex = getNextQuestionIndex(m_currentQuestionIndex);
-    if (nextIndex < m_showQuestions.size()) {
-        renderQuestionPage(nextIndex);
-        m_stackedWidget->setCurrentIndex(nextIndex);
-
-        m_currentQuestionIndex = nextIndex;
-        updateProgress(m_showNum); // 更新进度条
-        m_scrollArea->verticalScrollBar()->setValue(0);
-        
-        // 更新按钮状态
-        m_prevButton->setEnabled(true);
-        if (nextIndex == m_showQuestions.size() - 1) {
-            m_nextButton->setVisible(false);
-            m_submitButton->setVisible(true);
-        }
+        break;
+    case SurveyNavigation::Goto:
+        showQuestion(navigation.targetIndex);
+        break;
+    default:
+        // 全局规则检查失败或已是最后一题，不继续执行
+        break;
     }
 }
 
-void SurveyFormWidget::saveCurrentAnswer(int questionIndex)
+void SurveyFormWidget::showQuestion(int questionIndex)
 {
     FUNCTION_LOG();
-    if (questionIndex < 0 || questionIndex >= m_showQuestions.size()) {
+    renderQuestionPage(questionIndex);
+    m_currentQuestionIndex = questionIndex;
+    updateProgress(m_showNum); // 更新进度条
+    m_scrollArea->verticalScrollBar()->setValue(0);
+
+    // 更新按钮状态
+    m_prevButton->setEnabled(questionIndex > 0);
+    m_nextButton->setVisible(questionIndex < m_model->visibleCount() - 1);
+    m_submitButton->setVisible(questionIndex == m_model->visibleCount() - 1);
+}
+
+void SurveyFormWidget::onAnswerEdited(int questionIndex)
+{
+    if (m_isRestoring) {
         return;
     }
 
-    QJsonObject currentAnswer = collectSingleQuestionAnswer(questionIndex);
-    m_answerCache[questionIndex] = currentAnswer;
+    // 只重新收集发生变化的这一道题
+    QuestionView *view = m_pageHost->view(questionIndex);
+    if (view && m_engine->setAnswer(view->questionId(), view->answer())) {
+        // 答案变化可能改变跳转结果，重新预测下一题
+        schedulePrefetch();
+    }
 }
 
-QString SurveyFormWidget::getAnswerValue(const QJsonObject& savedAnswer, const QString& field)
+void SurveyFormWidget::schedulePrefetch()
 {
-    FUNCTION_LOG();
-    if (savedAnswer.contains(field)) {
-        QJsonObject fieldObj = savedAnswer[field].toObject();
-        if (!fieldObj.isEmpty()) {
-            // 返回第一个值（适用于单选、填空等）
-            return fieldObj.begin().value().toString();
-        }
-    }
-    return QString();
+    // 计时器在事件循环空闲后触发，不影响当前页面的显示和输入
+    m_prefetchTimer->start();
 }
 
-QJsonObject SurveyFormWidget::collectSingleQuestionAnswer(int questionIndex)
+void SurveyFormWidget::prefetchNextPage()
 {
     FUNCTION_LOG();
-    QJsonObject answer;
-
-    if (questionIndex < 0 || questionIndex >= m_showQuestions.size()) {
-        return answer;
-    }
-
-    QWidget* page = m_questionPages[questionIndex];
-    if (!page) return answer;
-
-    QList<QWidget*> widgets = page->findChildren<QWidget*>();
-    QJsonObject question = m_showQuestions[questionIndex];
-    QString field = question["id"].toString();
-    QString type = question["type"].toString();
-
-    // 根据题型收集答案，确保格式与collectAnswers()一致
-    if (type == "FillBlank") {
-        for (QWidget* widget : widgets) {
-            if (QLineEdit* lineEdit = qobject_cast<QLineEdit*>(widget)) {
-                if (lineEdit->property("field").toString() == field) {
-                    QString value = lineEdit->text();
-                    if (!value.isEmpty()) {
-                        // 格式: {"questionId": {"optionId": "value"}}
-                        QString id = lineEdit->property("id").toString();
-                        if (!id.isEmpty()) {
-                            answer[field] = QJsonObject{{id, value}};
-                        }
-                    }
-                    break; // 每个填空题只有一个输入框
-                }
-            }
-        }
-    }
-    else if (type == "Textarea") {
-        for (QWidget* widget : widgets) {
-            if (QTextEdit* textEdit = qobject_cast<QTextEdit*>(widget)) {
-                if (textEdit->property("field").toString() == field) {
-                    QString value = textEdit->toPlainText();
-                    if (!value.isEmpty()) {
-                        // 格式: {"questionId": {"optionId": "value"}}
-                        QString id = textEdit->property("id").toString();
-                        if (!id.isEmpty()) {
-                            answer[field] = QJsonObject{{id, value}};
-                        }
-                    }
-                    break;
-                }
-            }
-        }
-    }
-    else if (type == "Radio") {
-        QJsonObject valueObj;
-        for (QWidget* widget : widgets) {
-            if (QRadioButton* radioButton = qobject_cast<QRadioButton*>(widget)) {
-                if (radioButton->property("field").toString() == field && radioButton->isChecked()) {
-                    QString value = radioButton->property("value").toString();
-                    // 格式: {"questionId": {"optionId": "optionText"}}
-                    valueObj[value] = radioButton->text();
-                    break; // 单选只选一个
-                }
-            }
-        }
-        if (!valueObj.isEmpty()) {
-            answer[field] = valueObj;
-        }
-    }
-    else if (type == "Checkbox") {
-        QJsonObject valueObj;
-        for (QWidget* widget : widgets) {
-            if (QCheckBox* checkBox = qobject_cast<QCheckBox*>(widget)) {
-                if (checkBox->property("field").toString() == field && checkBox->isChecked()) {
-                    QString value = checkBox->property("value").toString();
-                    // 格式: {"questionId": {"optionId1": "optionText1", "optionId2": "optionText2"}}
-                    valueObj[value] = checkBox->text();
-                }
-            }
-        }
-        if (!valueObj.isEmpty()) {
-            answer[field] = valueObj;
-        }
-    }
-    else if (type == "Select") {
-        for (QWidget* widget : widgets) {
-            if (QComboBox* comboBox = qobject_cast<QComboBox*>(widget)) {
-                if (comboBox->property("field").toString() == field) {
-                    int currentIndex = comboBox->currentIndex();
-                    if (currentIndex > 0) { // 排除"请选择"
-                        QString value = comboBox->currentData().toString();
-                        // 格式: {"questionId": {"optionId": "optionId"}}
-                        answer[field] = QJsonObject{{value, value}};
-                    }
-                    break;
-                }
-            }
-        }
-    }
-    else if (type == "MultipleBlank") {
-        QJsonObject valueObj;
-        for (QWidget* widget : widgets) {
-            if (QLineEdit* lineEdit = qobject_cast<QLineEdit*>(widget)) {
-                if (lineEdit->property("field").toString() == field) {
-                    QString value = lineEdit->text();
-                    QString subField = lineEdit->property("subField").toString();
-                    if (!value.isEmpty() && !subField.isEmpty()) {
-                        // 格式: {"questionId": {"subFieldId": "value"}}
-                        valueObj[subField] = value;
-                    }
-                }
-            }
-        }
-        if (!valueObj.isEmpty()) {
-            answer[field] = valueObj;
-        }
+    // 按翻页时相同的跳转逻辑预测下一题，规则结果由引擎缓存
+    int nextIndex = m_engine->predictNextIndex(m_currentQuestionIndex);
+    if (nextIndex < 0 || nextIndex >= m_model->visibleCount()) {
+        return;
     }
-    else if (type == "Score" || type == "Nps") {
-        for (QWidget* widget : widgets) {
-            if (QSlider* slider = qobject_cast<QSlider*>(widget)) {
-                if (slider->property("field").toString() == field) {
-                    int value = slider->value();
-                    // 格式: {"questionId": {"questionId": "value"}}
-                    answer[field] = QJsonObject{{field, QString::number(value)}};
-                    break;
-                }
-            }
-        }
+    if (nextIndex == m_prefetchIndex && m_pageHost->isLive(nextIndex)) {
+        return;
     }
-    // 处理有填空的Radio和Checkbox选项
-    processOptionsWithBlankInputs(page, field, answer);
 
-    return answer;
-}
+    // 只保留当前页、上一页和新预测的页面，预测变化时之前预取的页面被回收
+    m_pageHost->retain({m_currentQuestionIndex - 1, m_currentQuestionIndex, nextIndex});
 
-void SurveyFormWidget::processOptionsWithBlankInputs(QWidget* page, const QString& field, QJsonObject& answer)
-{
-    FUNCTION_LOG();
-    // 处理单选按钮中的填空输入框
-    QList<QRadioButton*> radioButtons = page->findChildren<QRadioButton*>();
-    for (QRadioButton* radioButton : radioButtons) {
-        if (radioButton->property("field").toString() == field && radioButton->isChecked()) {
-            // 查找关联的输入框
-            QLineEdit* lineEdit = findAssociatedLineEdit(radioButton);
-            if (lineEdit && lineEdit->isEnabled() && !lineEdit->text().isEmpty()) {
-                QString value = lineEdit->text();
-                QString subField = lineEdit->property("subField").toString();
-                QString id = lineEdit->property("id").toString();
-
-                if (!answer.contains(field)) {
-                    answer[field] = QJsonObject();
-                }
-
-                QJsonObject obj = answer[field].toObject();
-                if (!obj.contains(subField)) {
-                    obj[subField] = QJsonObject();
-                }
-
-                QJsonObject subObj = obj[subField].toObject();
-                subObj[id] = value;
-                obj[subField] = subObj;
-                answer[field] = obj;
-            }
-            break; // 单选只处理一个
-        }
+    bool created = false;
+    m_isRestoring = true;
+    QuestionView *view = m_pageHost->materialize(nextIndex, &created);
+    m_isRestoring = false;
+    if (!view) {
+        return;
     }
-
-    // 处理复选框中的填空输入框
-    QList<QCheckBox*> checkBoxes = page->findChildren<QCheckBox*>();
-    for (QCheckBox* checkBox : checkBoxes) {
-        if (checkBox->property("field").toString() == field && checkBox->isChecked()) {
-            // 查找关联的输入框
-            QLineEdit* lineEdit = findAssociatedLineEdit(checkBox);
-            if (lineEdit && lineEdit->isEnabled() && !lineEdit->text().isEmpty()) {
-                QString value = lineEdit->text();
-                QString subField = lineEdit->property("subField").toString();
-                QString id = lineEdit->property("id").toString();
-
-                if (!answer.contains(field)) {
-                    answer[field] = QJsonObject();
-                }
-
-                QJsonObject obj = answer[field].toObject();
-                if (!obj.contains(subField)) {
-                    obj[subField] = QJsonObject();
-                }
-
-                QJsonObject subObj = obj[subField].toObject();
-                subObj[id] = value;
-                obj[subField] = subObj;
-                answer[field] = obj;
-            }
-        }
+    if (created) {
+        restoreAnswer(nextIndex);
     }
-}
 
-QLineEdit* SurveyFormWidget::findAssociatedLineEdit(QWidget* optionWidget)
-{
-    FUNCTION_LOG();
-    // 在同一个布局中查找关联的输入框
-    QLayout* parentLayout = optionWidget->parentWidget()->layout();
-    if (!parentLayout) return nullptr;
-
-    for (int i = 0; i < parentLayout->count(); ++i) {
-        QLayoutItem* item = parentLayout->itemAt(i);
-        if (item && item->widget()) {
-            if (QLineEdit* lineEdit = qobject_cast<QLineEdit*>(item->widget())) {
-                // 检查是否在同一个水平布局中
-                if (lineEdit->parentWidget() == optionWidget->parentWidget()) {
-                    return lineEdit;
-                }
-            }
-        }
+    // 提前完成布局计算，翻页时直接切换页面
+    QWidget *page = m_pageHost->page(nextIndex);
+    page->setMinimumHeight(0);
+    page->adjustSize();
+    page->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::MinimumExpanding);
+    if (page->layout()) {
+        page->layout()->activate();
     }
 
-    return nullptr;
+    m_prefetchIndex = nextIndex;
 }
 
 void SurveyFormWidget::restoreAnswer(int questionIndex)
 {
     FUNCTION_LOG();
-    if (!m_answerCache.contains(questionIndex)) {
+    QuestionView *view = m_pageHost->view(questionIndex);
+    if (!view) {
         return;
     }
 
-    QJsonObject savedAnswer = m_answerCache[questionIndex];
-    if (savedAnswer.isEmpty()) {
+    QJsonObject fieldAnswer = m_engine->answers()->answer(view->questionId());
+    if (fieldAnswer.isEmpty()) {
         return;
     }
 
-    // 获取当前页面
-    QWidget *page = m_questionPages[questionIndex];
-    if (!page) return;
-
-    // 获取题目信息
-    QJsonObject question = m_showQuestions[questionIndex];
-    QString field = question["id"].toString();
-    QString type = question["type"].toString();
-
-    if (!savedAnswer.contains(field)) {
-        return;
-    }
-
-    QJsonObject fieldAnswer = savedAnswer[field].toObject();
-
-    // 根据题型恢复答案
-    if (type == "FillBlank") {
-        QLineEdit* lineEdit = page->findChild<QLineEdit*>();
-        if (lineEdit) {
-            // 获取第一个答案值
-            if (!fieldAnswer.isEmpty()) {
-                QString value = fieldAnswer.begin().value().toString();
-                lineEdit->setText(value);
-            }
-        }
-    }
-    else if (type == "Textarea") {
-        QTextEdit* textEdit = page->findChild<QTextEdit*>();
-        if (textEdit) {
-            if (!fieldAnswer.isEmpty()) {
-                QString value = fieldAnswer.begin().value().toString();
-                textEdit->setPlainText(value);
-            }
-        }
-    }
-    else if (type == "Radio") {
-        QList<QRadioButton*> radioButtons = page->findChildren<QRadioButton*>();
-        for (QRadioButton* radio : radioButtons) {
-            QString optionValue = radio->property("value").toString();
-            if (fieldAnswer.contains(optionValue)) {
-                radio->setChecked(true);
-
-                // 处理关联的填空输入框
-                QLineEdit* lineEdit = findAssociatedLineEdit(radio);
-                if (lineEdit) {
-                    // 查找填空输入框的答案
-                    QString subField = lineEdit->property("subField").toString();
-                    if (fieldAnswer.contains(subField)) {
-                        QJsonObject subAnswer = fieldAnswer[subField].toObject();
-                        if (!subAnswer.isEmpty()) {
-                            QString blankValue = subAnswer.begin().value().toString();
-                            lineEdit->setText(blankValue);
-                            lineEdit->setEnabled(true);
-                        }
-                    }
-                }
-                break;
-            }
-        }
-    }
-    else if (type == "Checkbox") {
-        QList<QCheckBox*> checkBoxes = page->findChildren<QCheckBox*>();
-        for (QCheckBox* checkBox : checkBoxes) {
-            QString optionValue = checkBox->property("value").toString();
-            if (fieldAnswer.contains(optionValue)) {
-                checkBox->setChecked(true);
-
-                // 处理关联的填空输入框
-                QLineEdit* lineEdit = findAssociatedLineEdit(checkBox);
-                if (lineEdit) {
-                    // 查找填空输入框的答案
-                    QString subField = lineEdit->property("subField").toString();
-                    if (fieldAnswer.contains(subField)) {
-                        QJsonObject subAnswer = fieldAnswer[subField].toObject();
-                        if (!subAnswer.isEmpty()) {
-                            QString blankValue = subAnswer.begin().value().toString();
-                            lineEdit->setText(blankValue);
-                            lineEdit->setEnabled(true);
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else if (type == "Select") {
-        QComboBox* comboBox = page->findChild<QComboBox*>();
-        if (comboBox) {
-            // 查找匹配的选项
-            for (int i = 0; i < comboBox->count(); ++i) {
-                QString itemData = comboBox->itemData(i).toString();
-                if (fieldAnswer.contains(itemData)) {
-                    comboBox->setCurrentIndex(i);
-                    break;
-                }
-            }
-        }
-    }
-    else if (type == "MultipleBlank") {
-        QList<QLineEdit*> lineEdits = page->findChildren<QLineEdit*>();
-        for (QLineEdit* lineEdit : lineEdits) {
-            QString subField = lineEdit->property("subField").toString();
-            if (fieldAnswer.contains(subField)) {
-                QString value = fieldAnswer[subField].toString();
-                lineEdit->setText(value);
-            }
-        }
-    }
-    else if (type == "Score" || type == "Nps") {
-        QSlider* slider = page->findChild<QSlider*>();
-        if (slider && fieldAnswer.contains(field)) {
-            QString valueStr = fieldAnswer[field].toString();
-            bool ok;
-            int value = valueStr.toInt(&ok);
-            if (ok) {
-                slider->setValue(value);
-            }
-        }
-    }
+    // 恢复过程中控件会发出变化信号，此时不回写答案存储
+    m_isRestoring = true;
+    view->setAnswer(fieldAnswer);
+    m_isRestoring = false;
 }
 
 void SurveyFormWidget::onPrevClicked()
 {
     FUNCTION_LOG();
-    // 保存当前题目的答案
-    saveCurrentAnswer(m_currentQuestionIndex);
-
-    if (m_currentQuestionIndex > 0) {
-        int prevIndex = m_currentQuestionIndex - 1;
-        renderQuestionPage(prevIndex);
-
-        // 恢复上一题的答案
-        restoreAnswer(prevIndex);
-
-        m_stackedWidget->setCurrentIndex(prevIndex);
-        m_currentQuestionIndex = prevIndex;
-        updateProgress(m_showNum);
-        m_scrollArea->verticalScrollBar()->setValue(0);
-
-        // 更新按钮状态
-        m_nextButton->setVisible(true);
-        m_submitButton->setVisible(false);
-        m_prevButton->setEnabled(prevIndex > 0);
+    // 渲染时会从答案存储恢复上一题的答案
+    SurveyNavigation navigation = m_engine->previous();
+    if (navigation.action == SurveyNavigation::Goto) {
+        showQuestion(navigation.targetIndex);
     }
 }
 
@@ -1237,155 +495,6 @@ void SurveyFormWidget::onBackToSurveyListClicked()
     emit backToSurveyList();
 }
 
-void SurveyFormWidget::evaluateJumpLogic(int currentQuestionIndex)
-{
-    // 这里可以实现跳转逻辑的评估
-    // 目前仅作占位，实际项目中需要根据题目答案和逻辑规则来判断是否跳转
-}
-
-int SurveyFormWidget::getNextQuestionIndex(int currentQuestionIndex)
-{
-    FUNCTION_LOG();
-    // 检查当前题目是否有跳转规则
-    if (currentQuestionIndex >= 0 && currentQuestionIndex < m_showQuestions.size()) {
-        QJsonObject question = m_showQuestions[currentQuestionIndex];
-        QJsonObject attribute = question["attribute"].toObject();
-        
-        // 检查是否有jumpRule
-        if (attribute.contains("jumpRule") && !attribute["jumpRule"].toString().isEmpty()) {
-            QString jumpRule = attribute["jumpRule"].toString();
-            
-            // 收集当前答案用于表达式计算
-            QJsonObject currentAnswers = collectAnswers();
-            
-            // 解析跳转规则表达式
-            if (evaluateExpression(jumpRule, currentAnswers)) {
-                // 如果表达式计算结果为true，需要解析跳转目标
-                // 处理jump函数表达式，如 "jump('questionId')"
-                QRegularExpression jumpRe("jump\\s*\\(\\s*['\"]?([\\w\\d]+)['\"]?\\s*\\)");
-                QRegularExpressionMatch jumpMatch = jumpRe.match(jumpRule);
-                if (jumpMatch.hasMatch()) {
-                    QString targetQuestionId = jumpMatch.captured(1);
-                    int targetIndex = findQuestionIndexById(targetQuestionId);
-                    if (targetIndex >= 0 && targetIndex < m_showQuestions.size()) {
-                        return targetIndex;
-                    }
-                }
-                
-                // 处理直接指定目标题号的表达式，如 "true && 'questionId'"
-                QRegularExpression idRe("'([\\w\\d]+)'");
-                QRegularExpressionMatch idMatch = idRe.match(jumpRule);
-                if (idMatch.hasMatch()) {
-                    QString targetQuestionId = idMatch.captured(1);
-                    int targetIndex = findQuestionIndexById(targetQuestionId);
-                    if (targetIndex >= 0 && targetIndex < m_showQuestions.size()) {
-                        return targetIndex;
-                    }
-                }
-                
-                // 处理条件表达式中的题目ID，如 "#{axq2}==#{axq2.feg4}" 中的目标题目
-                // 这种情况下，如果条件满足，跳转到下一题
-            }
-        }
-    }
-    
-    // 默认返回下一题
-    return currentQuestionIndex + 1;
-}
-
-bool SurveyFormWidget::evaluateFinishRule(int currentQuestionIndex)
-{
-    FUNCTION_LOG();
-    // 检查当前题目是否有结束规则
-    if (currentQuestionIndex >= 0 && currentQuestionIndex < m_showQuestions.size()) {
-        QJsonObject question = m_showQuestions[currentQuestionIndex];
-        QJsonObject attribute = question["attribute"].toObject();
-        
-        // 检查是否有finishRule
-        if (attribute.contains("finishRule") && !attribute["finishRule"].toString().isEmpty()) {
-            QString finishRule = attribute["finishRule"].toString();
-            
-            // 收集当前答案用于表达式计算
-            QJsonObject currentAnswers = collectAnswers();
-            
-            // 解析结束规则表达式
-            return evaluateExpression(finishRule, currentAnswers);
-        }
-    }
-    
-    return false; // 默认不结束
-}
-
-bool SurveyFormWidget::evaluateGlobalRules()
-{
-    FUNCTION_LOG();
-    // 获取问卷属性中的全局规则
-    QJsonObject survey = m_schema["survey"].toObject();
-    QJsonObject surveyAttribute = survey["attribute"].toObject();
-
-    if (surveyAttribute.contains("globalRule") && surveyAttribute["globalRule"].isArray()) {
-        QJsonArray globalRules = surveyAttribute["globalRule"].toArray();
-        QJsonObject currentAnswers = collectAnswers();
-
-        // 遍历所有全局规则
-        for (int i = 0; i < globalRules.size(); ++i) {
-            QString rule = globalRules[i].toString();
-
-            // 尝试将规则解析为JSON对象
-            QJsonDocument ruleDoc = QJsonDocument::fromJson(rule.toUtf8());
-            if (!ruleDoc.isNull() && ruleDoc.isObject()) {
-                QJsonObject ruleObj = ruleDoc.object();
-
-                // 检查是否为跳转类型的全局规则
-                if (ruleObj.contains("conditionItem") && ruleObj.contains("result")) {
-                    // 处理条件逻辑
-                    bool conditionResult = evaluateGlobalRuleConditions(ruleObj, currentAnswers);
-
-                    // 如果条件满足，处理结果
-                    if (conditionResult) {
-                        QJsonArray results = ruleObj["result"].toArray();
-                        for (int j = 0; j < results.size(); ++j) {
-                            QJsonObject result = results[j].toObject();
-                            if (result["type"].toString() == "jump") {
-                                QString targetQuestionId = result["qId"].toString();
-                                int targetIndex = findQuestionIndexById(targetQuestionId);
-                                if (targetIndex != -1) {
-                                    // 执行跳转
-                                    renderQuestionPage(targetIndex);
-                                    m_stackedWidget->setCurrentIndex(targetIndex);
-                                    m_currentQuestionIndex = targetIndex;
-                                    updateProgress(m_showNum);
-                                    m_scrollArea->verticalScrollBar()->setValue(0);
-
-                                    // 更新按钮状态
-                                    m_prevButton->setEnabled(targetIndex > 0);
-                                    m_nextButton->setVisible(targetIndex < m_showQuestions.size() - 1);
-                                    m_submitButton->setVisible(targetIndex == m_showQuestions.size() - 1);
-
-                                    // 对于跳转类型的全局规则，我们不需要阻止用户继续操作
-                                    // 只是跳转到指定题目
-                                    return true;
-                                }
-                            }
-                        }
-                    }
-                    // 如果条件不满足，继续检查其他全局规则
-                    continue;
-                }
-            }
-
-            // 如果不是结构化规则，按表达式处理
-            if (!evaluateExpression(rule, currentAnswers)) {
-                // 可以添加提示信息，告诉用户全局规则验证失败
-                return false;
-            }
-        }
-    }
-
-    // 如果没有全局规则或所有规则都通过，则返回true
-    return true;
-}
-
 void SurveyFormWidget::updateRecordTime(qint64 duration)
 {
 
@@ -1414,20 +523,14 @@ void SurveyFormWidget::capturePhoto()
     captureSession->setImageCapture(imageCapture);
     imageCapture->setQuality(QImageCapture::HighQuality);
 
-    // 连接图片捕获信号
-    connect(imageCapture, &QImageCapture::imageCaptured, this, [this, filePath](int id, const QImage &preview) {
+    // 照片由captureToFile写入文件，写完后立即在后台上传，提交时不必再集中上传
+    connect(imageCapture, &QImageCapture::imageSaved, this, [this, imageCapture](int id, const QString &fileName) {
         Q_UNUSED(id)
-        // 保存图片到文件
-        if (preview.save(filePath, "JPG")) {
-            m_capturedPhotos.append(filePath);
-            qDebug() << "照片已保存:" << filePath;
-        } else {
-            qWarning() << "保存照片失败:" << filePath;
+        qDebug() << "照片已保存:" << fileName;
+        // 已停止拍照时由stopAutoCapture统一处理
+        if (m_camera->isActive()) {
+            uploadCapturedPhoto(fileName);
         }
-    });
-
-    // 拍摄完成后删除imageCapture对象
-    connect(imageCapture, &QImageCapture::imageSaved, this, [imageCapture]() {
         // 从捕获会话中断开连接
         imageCapture->captureSession()->setImageCapture(nullptr);
         imageCapture->deleteLater();
@@ -1462,400 +565,11 @@ void SurveyFormWidget::onCameraActiveChanged()
     }
 }
 
-bool SurveyFormWidget::evaluateExpression(const QString& expression, const QJsonObject& answers)
-{
-    FUNCTION_LOG();
-    // 这是一个简化的表达式计算器实现
-    // 实际项目中应该实现一个完整的表达式解析器
-    
-    // 处理空表达式
-    if (expression.trimmed().isEmpty()) {
-        return false;
-    }
-    
-    // 处理简单布尔值
-    if (expression.trimmed().compare("true", Qt::CaseInsensitive) == 0) {
-        return true;
-    }
-    if (expression.trimmed().compare("false", Qt::CaseInsensitive) == 0) {
-        return false;
-    }
-    
-    // 处理比较两个题目答案的表达式，如 "#{questionId1} == #{questionId2.subField}"
-    QRegularExpression twoVarsRe("#\\{([\\w\\d]+)(?:\\.([\\w\\d]+))?\\}\\s*(==|!=)\\s*#\\{([\\w\\d]+)(?:\\.([\\w\\d]+))?\\}");
-    QRegularExpressionMatch twoVarsMatch = twoVarsRe.match(expression);
-    if (twoVarsMatch.hasMatch()) {
-        QString questionId1 = twoVarsMatch.captured(1);
-        QString subField1 = twoVarsMatch.captured(2);
-        QString operatorStr = twoVarsMatch.captured(3);
-        QString questionId2 = twoVarsMatch.captured(4);
-        QString subField2 = twoVarsMatch.captured(5);
-        
-        QString value1, value2;
-        bool hasValue1 = false, hasValue2 = false;
-        
-        // 获取第一个题目的值
-        if (answers.contains(questionId1)) {
-            QJsonObject answerObj1 = answers[questionId1].toObject();
-            if (!subField1.isEmpty() && answerObj1.contains(subField1)) {
-                value1 = answerObj1[subField1].toString();
-                hasValue1 = true;
-            } else if(!subField1.isEmpty()){
-                QJsonArray array = m_showQuestions[m_currentQuestionIndex]["children"].toArray();
-                foreach(auto obj, array)
-                {
-                    if(obj.toObject()["id"].toString() == subField1)
-                    {
-                        value1 = obj.toObject()["title"].toString();
-                        hasValue1 = true;
-                        break;
-                    }
-                }
-            }
-            else
-            {
-                // 遍历查找值
-                for (auto it = answerObj1.begin(); it != answerObj1.end(); ++it) {
-                    if (it.value().isString()) {
-                        value1 = it.value().toString();
-                        hasValue1 = true;
-                        break;
-                    }
-                }
-            }
-        }
-        
-        // 获取第二个题目的值
-        if (answers.contains(questionId2)) {
-            QJsonObject answerObj2 = answers[questionId2].toObject();
-            if (!subField2.isEmpty() && answerObj2.contains(subField2)) {
-                value2 = answerObj2[subField2].toString();
-                hasValue2 = true;
-            }else if(!subField2.isEmpty()){
-                QJsonArray array = m_showQuestions[m_currentQuestionIndex]["children"].toArray();
-                foreach(auto obj, array)
-                {
-                    if(obj.toObject()["id"].toString() == subField2)
-                    {
-                        value2 = obj.toObject()["title"].toString();
-                        hasValue2 = true;
-                        break;
-                    }
-                }
-            } else {
-                // 遍历查找值
-                for (auto it = answerObj2.begin(); it != answerObj2.end(); ++it) {
-                    if (it.value().isString()) {
-                        value2 = it.value().toString();
-                        hasValue2 = true;
-                        break;
-                    }
-                }
-            }
-        }
-        
-        if (operatorStr == "==") {
-            return hasValue1 && hasValue2 && (value1 == value2);
-        } else if (operatorStr == "!=") {
-            if (!hasValue1 || !hasValue2) {
-                return true; // 如果任一值不存在，则认为不相等
-            }
-            return value1 != value2;
-        }
-    }
-    
-    // 处理等于比较表达式，如 "#{questionId} == 'value'"
-    QRegularExpression eqRe("#\\{([\\w\\d]+)(?:\\.([\\w\\d]+))?\\}\\s*(==|!=)\\s*['\"](.*)['\"]");
-    QRegularExpressionMatch eqMatch = eqRe.match(expression);
-    if (eqMatch.hasMatch()) {
-        QString questionId = eqMatch.captured(1);
-        QString subField = eqMatch.captured(2);
-        QString operatorStr = eqMatch.captured(3);
-        QString expectedValue = eqMatch.captured(4);
-        
-        // 查找该题目的答案
-        if (answers.contains(questionId)) {
-            QJsonObject answerObj = answers[questionId].toObject();
-            bool hasValue = false;
-            QString actualValue;
-            
-            if (!subField.isEmpty() && answerObj.contains(subField)) {
-                // 处理子字段
-                QJsonObject subObj = answerObj[subField].toObject();
-                for (auto it = subObj.begin(); it != subObj.end(); ++it) {
-                    if (it.value().isString()) {
-                        actualValue = it.value().toString();
-                        hasValue = true;
-                        break;
-                    }
-                }
-            } else {
-                // 遍历答案对象，查找匹配的值
-                for (auto it = answerObj.begin(); it != answerObj.end(); ++it) {
-                    if (it.value().isString()) {
-                        actualValue = it.value().toString();
-                        hasValue = true;
-                        break;
-                    }
-                }
-            }
-            
-            if (operatorStr == "==") {
-                return hasValue && (actualValue == expectedValue);
-            } else if (operatorStr == "!=") {
-                return !hasValue || (actualValue != expectedValue);
-            }
-        } else {
-            // 如果问题没有答案，根据操作符决定返回值
-            if (operatorStr == "!=" && expectedValue.isEmpty()) {
-                return true;
-            }
-        }
-    }
-    
-    // 处理存在性检查表达式，如 "#{questionId} != ''"
-    QRegularExpression existRe("#\\{([\\w\\d]+)(?:\\.([\\w\\d]+))?\\}\\s*!=\\s*['\"]['\"]");
-    QRegularExpressionMatch existMatch = existRe.match(expression);
-    if (existMatch.hasMatch()) {
-        QString questionId = existMatch.captured(1);
-        QString subField = existMatch.captured(2);
-        
-        // 查找该题目的答案
-        if (answers.contains(questionId)) {
-            QJsonObject answerObj = answers[questionId].toObject();
-            if (!subField.isEmpty()) {
-                return answerObj.contains(subField) && !answerObj[subField].toObject().isEmpty();
-            }
-            return !answerObj.isEmpty();
-        }
-        return false;
-    }
-    
-    // 处理存在性检查表达式，如 "#{questionId} == ''"
-    QRegularExpression notExistRe("#\\{([\\w\\d]+)(?:\\.([\\w\\d]+))?\\}\\s*==\\s*['\"]['\"]");
-    QRegularExpressionMatch notExistMatch = notExistRe.match(expression);
-    if (notExistMatch.hasMatch()) {
-        QString questionId = notExistMatch.captured(1);
-        QString subField = notExistMatch.captured(2);
-        
-        // 查找该题目的答案
-        if (answers.contains(questionId)) {
-            QJsonObject answerObj = answers[questionId].toObject();
-            if (!subField.isEmpty()) {
-                return !answerObj.contains(subField) || answerObj[subField].toObject().isEmpty();
-            }
-            return answerObj.isEmpty();
-        }
-        return true;
-    }
-    
-    // 处理跳转表达式，如 "jump('questionId')"
-    QRegularExpression jumpRe("jump\\s*\\(\\s*['\"]?([\\w\\d]+)['\"]?\\s*\\)");
-    QRegularExpressionMatch jumpMatch = jumpRe.match(expression);
-    if (jumpMatch.hasMatch()) {
-        // jump函数表示满足条件，应该执行跳转
-        return true;
-    }
-    
-    // 处理包含函数，如 "includes(#{questionId}, 'value')"
-    QRegularExpression includesRe("includes\\s*\\(\\s*#\\{([\\w\\d]+)(?:\\.([\\w\\d]+))?\\}\\s*,\\s*['\"](.*)['\"]\\s*\\)");
-    QRegularExpressionMatch includesMatch = includesRe.match(expression);
-    if (includesMatch.hasMatch()) {
-        QString questionId = includesMatch.captured(1);
-        QString subField = includesMatch.captured(2);
-        QString valueToCheck = includesMatch.captured(3);
-        
-        if (answers.contains(questionId)) {
-            QJsonObject answerObj = answers[questionId].toObject();
-            if (!subField.isEmpty() && answerObj.contains(subField)) {
-                QJsonObject subObj = answerObj[subField].toObject();
-                for (auto it = subObj.begin(); it != subObj.end(); ++it) {
-                    if (it.value().toString() == valueToCheck) {
-                        return true;
-                    }
-                }
-            } else {
-                // 检查答案中是否包含指定值
-                for (auto it = answerObj.begin(); it != answerObj.end(); ++it) {
-                    if (it.value().toString() == valueToCheck) {
-                        return true;
-                    }
-                }
-            }
-        }
-    }
-    
-    // 更复杂的表达式处理需要实现完整的表达式解析器
-    // 这里只是简单示例
-    
-    // 默认情况下，尝试解析为布尔表达式
-    return false;
-}
-
-bool SurveyFormWidget::evaluateGlobalRuleConditions(const QJsonObject &rule, const QJsonObject &currentAnswers)
-{
-    FUNCTION_LOG();
-    QJsonArray conditionItems = rule["conditionItem"].toArray();
-    QString conditionLogic = rule["conditionLogic"].toString("AND");
-
-    bool finalResult = (conditionLogic == "AND") ? true : false;
-
-    for (int i = 0; i < conditionItems.size(); ++i) {
-        QJsonObject conditionItem = conditionItems[i].toObject();
-        QString qId = conditionItem["qId"].toString();
-        QString condition = conditionItem["condition"].toString();
-        QJsonArray oIds = conditionItem["oId"].toArray();
-
-        bool conditionResult = false;
-
-        // 检查当前答案中是否有对应的题目
-        if (currentAnswers.contains(qId)) {
-            QJsonObject questionAnswer = currentAnswers[qId].toObject();
-
-            if (condition == "CHECKED") {
-                // 检查是否选中了指定的选项
-                for (int j = 0; j < oIds.size(); ++j) {
-                    QString oId = oIds[j].toString();
-                    if (questionAnswer.contains(oId)) {
-                        conditionResult = true;
-                        break;
-                    }
-                }
-            }
-        }
-
-        // 根据逻辑运算符更新最终结果
-        if (conditionLogic == "AND") {
-            finalResult = finalResult && conditionResult;
-        } else if (conditionLogic == "OR") {
-            finalResult = finalResult || conditionResult;
-        }
-
-        // 对于AND逻辑，如果任何一个条件为false，可以提前退出
-        if (conditionLogic == "AND" && !finalResult) {
-            break;
-        }
-    }
-
-    return finalResult;
-}
-
-int SurveyFormWidget::findQuestionIndexById(const QString& questionId)
-{
-    FUNCTION_LOG();
-    for (int i = 0; i < m_showQuestions.size(); ++i) {
-        if (m_showQuestions[i]["id"].toString() == questionId) {
-            return i;
-        }
-    }
-    return -1; // 未找到
-}
-
-bool SurveyFormWidget::isQuestionRequired(int questionIndex)
-{
-    FUNCTION_LOG();
-    if (questionIndex < 0 || questionIndex >= m_showQuestions.size()) {
-        return false;
-    }
-    
-    QJsonObject question = m_showQuestions[questionIndex];
-    QJsonObject attribute = question["attribute"].toObject();
-    return attribute["required"].toBool();
-}
-
-bool SurveyFormWidget::isQuestionAnswered(int questionIndex)
-{
-    FUNCTION_LOG();
-    if (questionIndex < 0 || questionIndex >= m_showQuestions.size()) {
-        return false;
-    }
-    
-    // 获取当前页面
-    QWidget *page = m_questionPages[questionIndex];
-    QList<QWidget*> widgets = page->findChildren<QWidget*>();
-    
-    QJsonObject question = m_showQuestions[questionIndex];
-    QString type = question["type"].toString();
-    QString field = question["id"].toString();
-    
-    // 根据题型检查是否已回答
-    if (type == "FillBlank") {
-        for (QWidget* widget : widgets) {
-            if (QLineEdit* lineEdit = qobject_cast<QLineEdit*>(widget)) {
-                if (lineEdit->property("field").toString() == field) {
-                    return !lineEdit->text().trimmed().isEmpty();
-                }
-            }
-        }
-    }
-    else if (type == "Textarea") {
-        for (QWidget* widget : widgets) {
-            if (QTextEdit* textEdit = qobject_cast<QTextEdit*>(widget)) {
-                if (textEdit->property("field").toString() == field) {
-                    return !textEdit->toPlainText().trimmed().isEmpty();
-                }
-            }
-        }
-    }
-    else if (type == "Radio") {
-        for (QWidget* widget : widgets) {
-            if (QRadioButton* radioButton = qobject_cast<QRadioButton*>(widget)) {
-                if (radioButton->property("field").toString() == field) {
-                    if (radioButton->isChecked()) {
-                        return true;
-                    }
-                }
-            }
-        }
-        return false; // 没有选中任何选项
-    }
-    else if (type == "Checkbox") {
-        for (QWidget* widget : widgets) {
-            if (QCheckBox* checkBox = qobject_cast<QCheckBox*>(widget)) {
-                if (checkBox->property("field").toString() == field) {
-                    if (checkBox->isChecked()) {
-                        return true;
-                    }
-                }
-            }
-        }
-        return false; // 没有选中任何选项
-    }
-    else if (type == "Select") {
-        for (QWidget* widget : widgets) {
-            if (QComboBox* comboBox = qobject_cast<QComboBox*>(widget)) {
-                if (comboBox->property("field").toString() == field) {
-                    return comboBox->currentIndex() > 0; // 排除"请选择"
-                }
-            }
-        }
-    }
-    else if (type == "MultipleBlank") {
-        for (QWidget* widget : widgets) {
-            if (QLineEdit* lineEdit = qobject_cast<QLineEdit*>(widget)) {
-                if (lineEdit->property("field").toString() == field) {
-                    if (lineEdit->text().trimmed().isEmpty()) {
-                        return false; // 有任何一个子字段为空就不算完成
-                    }
-                }
-            }
-        }
-        return true; // 所有子字段都已填写
-    }
-    else if (type == "Score" || type == "Nps") {
-        // 评分题默认已回答（因为有默认值0）
-        return true;
-    }
-    
-    // 其他类型默认返回true
-    return true;
-}
-
 void SurveyFormWidget::onSubmitClicked()
 {
     FUNCTION_LOG();
     // 检查最后一题是否为必填题但未回答
-    if (isQuestionRequired(m_currentQuestionIndex) && !isQuestionAnswered(m_currentQuestionIndex)) {
+    if (m_engine->submit().action == SurveyNavigation::RequiredMissing) {
         QMessageBox::warning(this, "提示", "这是必填题，请完成作答后再提交");
         return;
     }
@@ -1865,7 +579,7 @@ void SurveyFormWidget::onSubmitClicked()
     // 更新进度条到100%
     if (m_progressBar && m_progressLabel) {
         m_progressBar->setValue(100);
-        m_progressLabel->setText(QString("进度: 100% (%1/%1)").arg(m_showQuestions.size()));
+        m_progressLabel->setText(QString("进度: 100% (%1/%1)").arg(m_model->visibleCount()));
     }
 
     // 停止录音
@@ -1880,139 +594,27 @@ void SurveyFormWidget::onSubmitClicked()
         StopRecord();
     }
 
-    // 如果有文件正在上传，则等待上传完成后再提交
-    if (m_isUploading) {
-        m_shouldSubmitAfterUpload = true;
-        // QMessageBox::information(this, "正在上传", "文件正在上传中，请稍候...");
-        return;
-    }
-
-    // 清空答案缓存
-    m_answerCache.clear();
-
     // 停止定位
     LocationManager::instance().stopContinuousLocationUpdates();
 
-    emit submitSurvey(collectAnswers());
+    // 不等待文件上传完成，还没有上传成功的文件随问卷一起进入提交队列，
+    // 网络管理器会接管正在上传的文件，不会重复上传
+    emit submitSurvey(collectAnswers(), pendingAttachments());
 }
 
 QJsonObject SurveyFormWidget::collectAnswers()
 {
     FUNCTION_LOG();
-    QJsonObject answers;
-
-    // 遍历所有题目页面收集答案
-    for (int i = 0; i < m_questionPages.size(); ++i) {
-        QWidget* page = m_questionPages[i];
-        QList<QWidget*> widgets = page->findChildren<QWidget*>();
-
-        for (QWidget* widget : widgets) {
-            QString field = widget->property("field").toString();
-            if (field.isEmpty()) continue;
-
-            // 根据控件类型收集答案
-            if (QLineEdit* lineEdit = qobject_cast<QLineEdit*>(widget)) {
-                QString value = lineEdit->text();
-                if (!value.isEmpty()) {
-                    // 检查是否是选项中的填空输入框
-                    QString subField = widget->property("subField").toString();
-                    QString id = widget->property("id").toString();
-                    if (!subField.isEmpty()) {
-                        // 这是选项中的填空输入框，需要特殊处理
-                        if (!answers.contains(field)) {
-                            answers[field] = QJsonObject();
-                        }
-                        QJsonObject obj = answers[field].toObject();
-                        QJsonObject cus;
-                        cus[id] = value;
-                        obj[subField] = cus;
-                        answers[field] = obj;
-                    } else {
-                        // 普通填空题
-                        answers[field] = QJsonObject{{widget->property("id").toString(), value}};
-                    }
-                }
-            }
-            else if (QTextEdit* textEdit = qobject_cast<QTextEdit*>(widget)) {
-                QString value = textEdit->toPlainText();
-                if (!value.isEmpty()) {
-                    answers[field] = QJsonObject{{widget->property("id").toString(), value}};
-                }
-            }
-            else if (QRadioButton* radioButton = qobject_cast<QRadioButton*>(widget)) {
-                if (radioButton->isChecked()) {
-                    QString value = radioButton->property("value").toString();
-                    // 单选题答案格式: {"questionId": {"optionId": "optionId"}}
-                    QJsonObject valueObj;
-                    valueObj[value] = radioButton->text();
-                    answers[field] = valueObj;
-                }
-            }
-            else if (QCheckBox* checkBox = qobject_cast<QCheckBox*>(widget)) {
-                if (checkBox->isChecked()) {
-                    QString value = checkBox->property("value").toString();
-                    // 多选题答案格式: {"questionId": {"optionId1": "optionId1", "optionId2": "optionId2"}}
-                    if (!answers.contains(field)) {
-                        answers[field] = QJsonObject();
-                    }
-                    QJsonObject obj = answers[field].toObject();
-                    obj[value] = checkBox->text();
-                    answers[field] = obj;
-                }
-            }
-            else if (QComboBox* comboBox = qobject_cast<QComboBox*>(widget)) {
-                int currentIndex = comboBox->currentIndex();
-                if (currentIndex > 0) { // 排除"请选择"
-                    QString value = comboBox->currentData().toString();
-                    // 下拉题答案格式: {"questionId": {"optionId": "optionId"}}
-                    QJsonObject valueObj;
-                    valueObj[value] = value;
-                    answers[field] = valueObj;
-                }
-            }
-            else if (QSlider* slider = qobject_cast<QSlider*>(widget)) {
-                int value = slider->value();
-                // 评分题答案格式: {"questionId": {"questionId": "value"}}
-                answers[field] = QJsonObject{{field, QString::number(value)}};
-            }
+    // 位置题的取值由界面读取定位结果，其余答案由问卷引擎组装
+    QString location;
+    if (m_model->locationQuestion()) {
+        LocationManager::LocationInfo info = LocationManager::instance().getLastKnownLocation();
+        if (info.isValid) {
+            location = QString("lat:%1,lon:%2,alt:%3").arg(QString::number(info.latitude)).arg(QString::number(info.longitude)).arg(QString::number(info.altitude));
         }
     }
 
-    // 处理上传题的答案数据
-    for (int i=0;i<m_uploadedFiles.size();i++) {
-
-        QString field = m_uploadedFiles[i].toObject()["field"].toString();
-        QString fileId = m_uploadedFiles[i].toObject()["id"].toString();
-        QString sub_id = m_uploadedFiles[i].toObject()["subField"].toString();
-
-        // 按照服务器要求的格式构建上传题答案
-        // 格式为: {"questionId": {"fileId": "fileId"}}
-        if (!fileId.isEmpty()) {
-            if(answers[field].toObject().empty())
-                answers[field] = QJsonObject();
-            QJsonObject obj = answers[field].toObject();
-            if(obj[sub_id].toArray().empty())
-            {
-                obj[sub_id] = QJsonArray();
-            }
-            QJsonArray array = obj[sub_id].toArray();
-            array.append(fileId);
-            obj[sub_id] = array;
-            answers[field] = obj;
-        }
-    }
-
-    if(!m_locationObj.isEmpty())
-    {
-        // 添加位置信息到客户端信息中
-        LocationManager::LocationInfo location = LocationManager::instance().getLastKnownLocation();
-        QString str;
-        if (location.isValid) {
-            str = QString("lat:%1,lon:%2,alt:%3").arg(QString::number(location.latitude)).arg(QString::number(location.longitude)).arg(QString::number(location.altitude));
-        }
-        answers[m_locationObj["id"].toString()] = QJsonObject{{m_locationObj["children"].toArray().at(0).toObject()["id"].toString(), str}};
-    }
-
+    QJsonObject answers = m_engine->submitPayload(&m_uploadJobs, location);
     qDebug()<<answers;
 
     return answers;
@@ -2091,7 +693,7 @@ void SurveyFormWidget::mouseReleaseEvent(QMouseEvent *event)
 void SurveyFormWidget::updateProgress(int num)
 {
     FUNCTION_LOG();
-    if (m_showQuestions.isEmpty()) return;
+    if (m_model->visibleCount() == 0) return;
 
     updateScrollBarVisibility();
 
@@ -2188,12 +790,31 @@ void SurveyFormWidget::adjustScrollBarRange(int pageHeight)
     }
 }
 
-void SurveyFormWidget::AddFile(QString id, QString path)
+quint64 SurveyFormWidget::AddFile(QString id, QString path)
 {
     FUNCTION_LOG();
-    QJsonObject obj;
-    obj[id] = path;
-    m_selectedFiles.append(obj);
+    // 上传结果按请求id对应到文件，同名文件也不会混淆
+    quint64 requestId = nextUploadRequestId();
+    const SurveyQuestion *question = m_model->question(id);
+    m_uploadJobs.add(requestId, id, question ? question->uploadSubField : QString(), path);
+    return requestId;
+}
+
+QJsonArray SurveyFormWidget::pendingAttachments() const
+{
+    // 提交时仍未上传成功的文件（如离线时上传失败），交给提交队列在联网后补传
+    QJsonArray attachments;
+    // requestId用于网络管理器接管正在上传的文件
+    const QList<const UploadJob*> jobs = m_uploadJobs.unfinishedJobs();
+    for (const UploadJob *job : jobs) {
+        attachments.append(QJsonObject{
+            {"field", job->questionId},
+            {"subField", job->subField},
+            {"path", job->path},
+            {"requestId", qint64(job->id)}
+        });
+    }
+    return attachments;
 }
 
 void SurveyFormWidget::requestAudioPermission()
@@ -2241,7 +862,7 @@ void SurveyFormWidget::StartRecord()
     QString dataPath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
 
     // 使用.wav扩展名
-    m_output = QString("%1/%2_%3.mp3").arg(dataPath).arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")).arg(m_schema["name"].toString());
+    m_output = QString("%1/%2_%3.mp3").arg(dataPath).arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")).arg(m_model->name());
     mediaRecorder->setOutputLocation(QUrl::fromLocalFile(m_output));
 
     // 开始录制
@@ -2298,12 +919,10 @@ void SurveyFormWidget::StopRecord()
     }
 
     // 上传有效的录音文件
-    if (!m_autoUpLoadObj.isEmpty()) {
+    if (const SurveyQuestion *autoUpload = m_model->autoUploadQuestion()) {
 
-        AddFile(m_autoUpLoadObj["id"].toString(), m_output);
-        m_pendingUploads++;  // 增加待上传计数
-        m_isUploading = true; // 设置上传状态为正在上传
-        emit UploadFile(m_schema["id"].toString(), m_autoUpLoadObj["id"].toString(), m_output);
+        quint64 requestId = AddFile(autoUpload->id, m_output);
+        emit UploadFile(requestId, m_model->id(), autoUpload->id, m_output, UploadPriority::Audio);
     }
 }
 
@@ -2357,7 +976,7 @@ void SurveyFormWidget::startAutoCapture()
 
     // 创建照片存储目录
     QString cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
-    QString dirName = QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss") + "_" + m_schema["name"].toString();
+    QString dirName = QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss") + "_" + m_model->name();
     m_photoDir = QDir(cachePath);
     if (!m_photoDir.exists(dirName)) {
         m_photoDir.mkpath(dirName);
@@ -2384,15 +1003,25 @@ void SurveyFormWidget::stopAutoCapture()
     m_photoDir.setNameFilters(QStringList()<<"*.jpg");
     QFileInfoList list = m_photoDir.entryInfoList();
 
+    // 拍摄时已经开始上传，这里只补上还没有加入上传队列的照片
+    int count = 0;
     for(int i=0;i<list.size();i++)
     {
-        // 上传全部照片
-        if (!m_autoUpLoadObj.isEmpty()) {
-            AddFile(m_autoUpLoadObj["id"].toString(), list.at(i).absoluteFilePath());
-            m_pendingUploads++;  // 增加待上传计数
-            m_isUploading = true; // 设置上传状态为正在上传
-            emit UploadFile(m_schema["id"].toString(), m_autoUpLoadObj["id"].toString(), list.at(i).absoluteFilePath());
+        if (uploadCapturedPhoto(list.at(i).absoluteFilePath())) {
+            ++count;
         }
     }
-    qDebug() << "自动拍照已停止 "<<"上传自动拍照文件数量"<<list.size();
+    qDebug() << "自动拍照已停止 "<<"照片数量"<<list.size()<<"补充上传"<<count;
+}
+
+bool SurveyFormWidget::uploadCapturedPhoto(const QString& filePath)
+{
+    const SurveyQuestion *autoUpload = m_model->autoUploadQuestion();
+    if (!autoUpload || m_capturedPhotos.contains(filePath)) {
+        return false;
+    }
+    m_capturedPhotos.append(filePath);
+    quint64 requestId = AddFile(autoUpload->id, filePath);
+    emit UploadFile(requestId, m_model->id(), autoUpload->id, filePath, UploadPriority::Photo);
+    return true;
 }
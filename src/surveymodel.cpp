@@ -0,0 +1,132 @@
+#include "surveymodel.h"
+#include <QJsonArray>
+#include <QDebug>
+
+QString SurveyQuestion::optionTitle(const QString& optionId) const
+{
+    int index = indexOfOption(optionId);
+    return index >= 0 ? options[index].title : QString();
+}
+
+QuestionType SurveyModel::parseType(const QString& typeName)
+{
+    static const QHash<QString, QuestionType> types = {
+        {"FillBlank", QuestionType::FillBlank},
+        {"Textarea", QuestionType::Textarea},
+        {"Radio", QuestionType::Radio},
+        {"Checkbox", QuestionType::Checkbox},
+        {"Select", QuestionType::Select},
+        {"MultipleBlank", QuestionType::MultipleBlank},
+        {"Score", QuestionType::Score},
+        {"Nps", QuestionType::Nps},
+        {"Cascader", QuestionType::Cascader},
+        {"Upload", QuestionType::Upload},
+        {"Signature", QuestionType::Signature},
+        {"Barcode", QuestionType::Barcode}
+    };
+    return types.value(typeName, QuestionType::Other);
+}
+
+QSharedPointer<const SurveyModel> SurveyModel::build(const QJsonObject& schema)
+{
+    QSharedPointer<SurveyModel> model = QSharedPointer<SurveyModel>::create();
+    model->m_id = schema["id"].toString();
+    model->m_name = schema["name"].toString();
+
+    // SurveyKing中问卷标题、描述和题目在survey字段中
+    QJsonObject survey = schema["survey"].toObject();
+    model->m_title = survey["title"].toString();
+    model->m_description = survey["description"].toString();
+
+    QJsonArray questions = survey["children"].toArray();
+    model->m_questions.reserve(questions.size());
+    for (int i = 0; i < questions.size(); ++i) {
+        QJsonObject questionObj = questions[i].toObject();
+        QJsonObject attribute = questionObj["attribute"].toObject();
+
+        SurveyQuestion question;
+        question.id = questionObj["id"].toString();
+        question.title = questionObj["title"].toString();
+        question.description = questionObj["description"].toString();
+        question.typeName = questionObj["type"].toString();
+        question.type = parseType(question.typeName);
+        question.required = attribute["required"].toBool();
+        question.hidden = attribute["display"].toString() == "hidden";
+
+        QJsonArray options = questionObj["children"].toArray();
+        question.options.reserve(options.size());
+        for (int j = 0; j < options.size(); ++j) {
+            QJsonObject optionObj = options[j].toObject();
+
+            SurveyOption option;
+            option.id = optionObj["id"].toString();
+            option.title = optionObj["title"].toString();
+            option.hasBlank = optionObj["attribute"].toObject()["dataType"].toString() == "horzBlank";
+            option.blankId = optionObj["children"].toArray().at(0).toObject()["id"].toString();
+
+            if (optionObj.contains("id")) {
+                question.uploadSubField = option.id;
+            }
+            question.optionIndex.insert(option.id, question.options.size());
+            question.options.append(option);
+        }
+
+        int index = model->m_questions.size();
+        if (!question.hidden) {
+            question.visibleIndex = model->m_visible.size();
+            model->m_visible.append(index);
+
+            // 跳转和结束规则只编译一次，答题过程中直接求值
+            model->m_jumpRules.append(RuleExpression::compile(attribute["jumpRule"].toString()));
+            model->m_finishRules.append(RuleExpression::compile(attribute["finishRule"].toString()));
+        }
+        else if (question.title == "录音和拍摄文件") {
+            // 保存自动上传相关的隐藏题目
+            model->m_autoUploadIndex = index;
+        }
+        else if (question.title == "位置信息") {
+            model->m_locationIndex = index;
+        }
+
+        model->m_questionIndex.insert(question.id, index);
+        model->m_questions.append(question);
+    }
+
+    // 跳转目标可能在后面的题目中，题目全部解析完成后再解析为下标
+    model->m_jumpTargets.reserve(model->m_jumpRules.size());
+    for (const RuleExpression& jumpRule : model->m_jumpRules) {
+        model->m_jumpTargets.append(model->visibleIndexOf(jumpRule.jumpTarget()));
+    }
+
+    // 全局规则在题目解析完成后编译，以便解析题目和选项下标
+    QJsonArray globalRules = survey["attribute"].toObject()["globalRule"].toArray();
+    for (int i = 0; i < globalRules.size(); ++i) {
+        QString rule = globalRules[i].toString();
+        GlobalRule globalRule = GlobalRule::compile(rule, *model);
+        if (globalRule.kind() == GlobalRule::Invalid) {
+            qWarning() << "全局规则解析失败，已忽略:" << rule << globalRule.expression().errorString();
+            continue;
+        }
+        model->m_globalRules.append(globalRule);
+    }
+
+    return model;
+}
+
+int SurveyModel::visibleIndexOf(const QString& questionId) const
+{
+    const SurveyQuestion *q = question(questionId);
+    return q ? q->visibleIndex : -1;
+}
+
+const SurveyQuestion* SurveyModel::question(const QString& questionId) const
+{
+    auto it = m_questionIndex.constFind(questionId);
+    return it != m_questionIndex.constEnd() ? &m_questions[it.value()] : nullptr;
+}
+
+QString SurveyModel::optionTitle(const QString& questionId, const QString& optionId) const
+{
+    const SurveyQuestion *q = question(questionId);
+    return q ? q->optionTitle(optionId) : QString();
+}
@@ -0,0 +1,127 @@
+#include "uploadjobtable.h"
+#include <QJsonArray>
+
+UploadJob& UploadJobTable::add(quint64 id, const QString& questionId, const QString& subField, const QString& path)
+{
+    UploadJob job;
+    job.id = id;
+    job.questionId = questionId;
+    job.subField = subField;
+    job.path = path;
+
+    if (!m_jobs.contains(id)) {
+        m_order.append(id);
+        m_byQuestion[questionId].append(id);
+    }
+    return m_jobs.insert(id, job).value();
+}
+
+void UploadJobTable::clear()
+{
+    m_jobs.clear();
+    m_byQuestion.clear();
+    m_order.clear();
+    m_uploadedCount = 0;
+}
+
+UploadJob *UploadJobTable::job(quint64 id)
+{
+    auto it = m_jobs.find(id);
+    return it != m_jobs.end() ? &it.value() : nullptr;
+}
+
+const UploadJob *UploadJobTable::job(quint64 id) const
+{
+    auto it = m_jobs.constFind(id);
+    return it != m_jobs.constEnd() ? &it.value() : nullptr;
+}
+
+bool UploadJobTable::setProgress(quint64 id, qint64 bytesSent, qint64 bytesTotal)
+{
+    UploadJob *uploadJob = job(id);
+    if (!uploadJob || uploadJob->isFinished()) {
+        return false;
+    }
+    uploadJob->state = UploadJob::Uploading;
+    uploadJob->bytesSent = bytesSent;
+    uploadJob->bytesTotal = bytesTotal;
+    return true;
+}
+
+bool UploadJobTable::markUploaded(quint64 id, const QString& fileId)
+{
+    UploadJob *uploadJob = job(id);
+    if (!uploadJob || uploadJob->isFinished()) {
+        return false;
+    }
+    uploadJob->state = UploadJob::Uploaded;
+    uploadJob->fileId = fileId;
+    uploadJob->bytesSent = uploadJob->bytesTotal;
+    ++m_uploadedCount;
+    return true;
+}
+
+bool UploadJobTable::markFailed(quint64 id)
+{
+    UploadJob *uploadJob = job(id);
+    if (!uploadJob || uploadJob->isFinished()) {
+        return false;
+    }
+    uploadJob->state = UploadJob::Failed;
+    return true;
+}
+
+QList<const UploadJob*> UploadJobTable::jobsForQuestion(const QString& questionId) const
+{
+    QList<const UploadJob*> jobs;
+    const QList<quint64> ids = m_byQuestion.value(questionId);
+    for (quint64 id : ids) {
+        jobs.append(job(id));
+    }
+    return jobs;
+}
+
+QList<const UploadJob*> UploadJobTable::unfinishedJobs() const
+{
+    QList<const UploadJob*> jobs;
+    if (m_uploadedCount == m_jobs.size()) {
+        return jobs;
+    }
+    for (quint64 id : m_order) {
+        const UploadJob *uploadJob = job(id);
+        if (!uploadJob->isFinished()) {
+            jobs.append(uploadJob);
+        }
+    }
+    return jobs;
+}
+
+void UploadJobTable::applyToAnswers(QJsonObject& answers) const
+{
+    if (m_uploadedCount == 0) {
+        return;
+    }
+    // 每道题只组装一次答案对象
+    for (auto it = m_byQuestion.constBegin(); it != m_byQuestion.constEnd(); ++it) {
+        QHash<QString, QJsonArray> filesBySubField;
+        for (quint64 id : it.value()) {
+            const UploadJob *uploadJob = job(id);
+            if (uploadJob->isFinished() && !uploadJob->fileId.isEmpty()) {
+                filesBySubField[uploadJob->subField].append(uploadJob->fileId);
+            }
+        }
+        if (filesBySubField.isEmpty()) {
+            continue;
+        }
+
+        QJsonObject answer = answers[it.key()].toObject();
+        for (auto files = filesBySubField.constBegin(); files != filesBySubField.constEnd(); ++files) {
+            QJsonArray array = answer[files.key()].toArray();
+            for (const QJsonValue& fileId : files.value()) {
+                array.append(fileId);
+            }
+            answer[files.key()] = array;
+        }
+        answers[it.key()] = answer;
+    }
+}
@@ -0,0 +1,88 @@
+#include "uploadscheduler.h"
+#include <algorithm>
+
+UploadScheduler::UploadScheduler(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void UploadScheduler::setMaxConcurrent(int maxConcurrent)
+{
+    m_maxConcurrent = qMax(1, maxConcurrent);
+    dispatch();
+}
+
+void UploadScheduler::setPriorityLimit(UploadPriority priority, int limit)
+{
+    m_priorityLimits[int(priority)] = qMax(0, limit);
+    dispatch();
+}
+
+quint64 UploadScheduler::enqueue(UploadPriority priority, const QVariantMap& task)
+{
+    quint64 id = m_nextId++;
+    m_tasks.insert(id, task);
+    m_queues[int(priority)].append(id);
+    dispatch();
+    emit queueDepthChanged(queuedCount(), runningCount());
+    return id;
+}
+
+bool UploadScheduler::cancel(quint64 id)
+{
+    if (!isQueued(id)) {
+        return false;
+    }
+    for (QList<quint64>& queue : m_queues) {
+        if (queue.removeOne(id)) {
+            break;
+        }
+    }
+    m_tasks.remove(id);
+    emit queueDepthChanged(queuedCount(), runningCount());
+    return true;
+}
+
+void UploadScheduler::finish(quint64 id)
+{
+    if (!m_running.remove(id)) {
+        return;
+    }
+    m_tasks.remove(id);
+    dispatch();
+    emit queueDepthChanged(queuedCount(), runningCount());
+}
+
+void UploadScheduler::dispatch()
+{
+    // taskStarted的处理函数可能同步结束任务（如文件不存在），由外层循环继续调度
+    if (m_dispatching) {
+        return;
+    }
+    m_dispatching = true;
+
+    // 每启动一个任务都从最高优先级重新检查，处理函数中可能加入了更高优先级的任务
+    bool started = true;
+    while (started) {
+        started = false;
+        for (int priority = 0; priority < PriorityCount; ++priority) {
+            QList<quint64>& queue = m_queues[priority];
+            // 答案请求很小，并发已满时也允许多占一个名额，提交不必等待正在上传的照片
+            int limit = priority == int(UploadPriority::Answer) ? m_maxConcurrent + 1 : m_maxConcurrent;
+            if (queue.isEmpty() || m_running.size() >= limit) {
+                continue;
+            }
+            if (m_priorityLimits[priority] > 0
+                && std::count(m_running.cbegin(), m_running.cend(), UploadPriority(priority)) >= m_priorityLimits[priority]) {
+                continue;
+            }
+            quint64 id = queue.takeFirst();
+            m_running.insert(id, UploadPriority(priority));
+            emit taskStarted(id, m_tasks.value(id));
+            started = true;
+            break;
+        }
+    }
+
+    m_dispatching = false;
+}
@@ -0,0 +1,227 @@
+// 多服务器切换验证工具
+// 用三个延迟不同的本地替身服务器检查ServerSelector:
+//   probe-ranking       从配置的慢服务器开始，探测后选择延迟最低的服务器
+//   failover            当前服务器停止后，请求失败一次不切换，达到阈值后切换到剩下最快的服务器
+//   recovery            原服务器恢复后重新探测，切换回明显更快的原服务器
+// 结果以JSON输出，全部通过时返回0。
+//
+// 用法: serverfailover [--rounds 3]
+
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QTimer>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QTextStream>
+#include <QDebug>
+#include "serverselector.h"
+#include "standinserver.h"
+
+// 各替身服务器的响应延迟，差距足够大，不受本机调度抖动影响
+static const int FastDelayMs = 20;
+static const int MediumDelayMs = 150;
+static const int SlowDelayMs = 400;
+static const int ProbeTimeoutMs = 2000;
+
+static qint64 totalProbes(const ServerSelector& selector)
+{
+    qint64 total = 0;
+    const QJsonArray servers = selector.metrics()["servers"].toArray();
+    for (const QJsonValue& server : servers) {
+        total += server.toObject()["probes"].toInteger();
+    }
+    return total;
+}
+
+// 等待探测次数累计到target，最后一个探测返回时已经完成重新选择
+static bool waitForProbes(const ServerSelector& selector, qint64 target)
+{
+    QEventLoop loop;
+    QTimer poll;
+    QObject::connect(&poll, &QTimer::timeout, &loop, [&]() {
+        if (totalProbes(selector) >= target) {
+            loop.quit();
+        }
+    });
+    bool timedOut = false;
+    QTimer::singleShot(ProbeTimeoutMs * 2, &loop, [&]() {
+        timedOut = true;
+        loop.quit();
+    });
+    poll.start(10);
+    loop.exec();
+    return !timedOut;
+}
+
+static bool runProbe(ServerSelector& selector)
+{
+    qint64 target = totalProbes(selector) + selector.serverCount();
+    selector.probe();
+    return waitForProbes(selector, target);
+}
+
+// 向当前服务器发一个普通请求，按NetworkManager::recordConnectionUse的规则报告结果，返回是否收到响应
+static bool sendRequest(QNetworkAccessManager& networkManager, ServerSelector& selector)
+{
+    QNetworkRequest request(QUrl(selector.current() + "/survey/list"));
+    request.setTransferTimeout(ProbeTimeoutMs);
+    QNetworkReply *reply = networkManager.get(request);
+    QEventLoop loop;
+    QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+    loop.exec();
+    bool responded = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).isValid();
+    if (responded) {
+        selector.reportSuccess(reply->url());
+    } else {
+        selector.reportFailure(reply->url());
+    }
+    reply->deleteLater();
+    return responded;
+}
+
+static QJsonArray serverStates(const ServerSelector& selector)
+{
+    QJsonArray states;
+    const QJsonArray servers = selector.metrics()["servers"].toArray();
+    for (const QJsonValue& value : servers) {
+        QJsonObject server = value.toObject();
+        states.append(QJsonObject{
+            {"baseUrl", server["baseUrl"]},
+            {"latencyMs", server["latencyMs"]},
+            {"healthy", server["healthy"]},
+            {"failovers", server["failovers"]}
+        });
+    }
+    return states;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    int rounds = 3;
+    const QStringList args = app.arguments();
+    for (int i = 1; i < args.size(); ++i) {
+        if (args[i] == "--rounds" && i + 1 < args.size()) {
+            rounds = qMax(1, args[++i].toInt());
+        }
+    }
+
+    StandInServer fast;
+    StandInServer medium;
+    StandInServer slow;
+    auto serve = [](StandInServer& server, int delayMs) {
+        server.setHandler([delayMs](const StandInRequest&) {
+            StandInResponse response = StandInResponse::json(QJsonObject{{"code", 200}});
+            response.delayMs = delayMs;
+            return response;
+        });
+        return server.start();
+    };
+    if (!serve(fast, FastDelayMs) || !serve(medium, MediumDelayMs) || !serve(slow, SlowDelayMs)) {
+        qWarning() << "替身服务器启动失败";
+        return 2;
+    }
+
+    QNetworkAccessManager networkManager;
+    ServerSelector selector(&networkManager);
+    selector.setProbeTimeout(ProbeTimeoutMs);
+    // 配置顺序与延迟顺序不同，上次使用的是最慢的一个
+    selector.setServers({slow.baseUrl(), fast.baseUrl(), medium.baseUrl()}, slow.baseUrl());
+    QStringList switches;
+    QObject::connect(&selector, &ServerSelector::currentChanged, [&switches](const QString& baseUrl) {
+        switches.append(baseUrl);
+    });
+
+    QJsonArray cases;
+    bool allPassed = true;
+    auto report = [&](const QString& name, bool passed, const QJsonObject& details) {
+        QJsonObject result = details;
+        result["case"] = name;
+        result["passed"] = passed;
+        result["servers"] = serverStates(selector);
+        cases.append(result);
+        allPassed = allPassed && passed;
+    };
+
+    // probe-ranking: 探测后从最慢的服务器切换到最快的，之后几轮保持不变
+    {
+        QString initial = selector.current();
+        bool completed = true;
+        for (int i = 0; i < rounds; ++i) {
+            completed = runProbe(selector) && completed;
+        }
+        bool passed = completed && initial == slow.baseUrl()
+                      && selector.current() == fast.baseUrl()
+                      && switches == QStringList{fast.baseUrl()};
+        report("probe-ranking", passed, QJsonObject{
+            {"initial", initial},
+            {"current", selector.current()},
+            {"switches", QJsonArray::fromStringList(switches)},
+            {"probesCompleted", completed}
+        });
+    }
+
+    // failover: 最快的服务器停止，第一次失败不切换，第二次切换到中速服务器而不是最慢的
+    {
+        switches.clear();
+        bool before = sendRequest(networkManager, selector);
+        fast.stop();
+        bool firstFailed = !sendRequest(networkManager, selector);
+        QString afterFirst = selector.current();
+        // 切换时会立即重新探测一次，等它结束后确认没有切回已停止的服务器
+        qint64 target = totalProbes(selector) + selector.serverCount();
+        bool secondFailed = !sendRequest(networkManager, selector);
+        QString afterSecond = selector.current();
+        bool completed = waitForProbes(selector, target);
+        bool served = sendRequest(networkManager, selector);
+        bool passed = before && firstFailed && secondFailed && completed && served
+                      && afterFirst == fast.baseUrl()
+                      && afterSecond == medium.baseUrl()
+                      && selector.current() == medium.baseUrl()
+                      && switches == QStringList{medium.baseUrl()};
+        report("failover", passed, QJsonObject{
+            {"afterFirstFailure", afterFirst},
+            {"afterSecondFailure", afterSecond},
+            {"current", selector.current()},
+            {"switches", QJsonArray::fromStringList(switches)},
+            {"servedAfterSwitch", served}
+        });
+    }
+
+    // recovery: 原服务器在同一端口恢复，重新探测后切换回去
+    {
+        switches.clear();
+        if (!fast.start()) {
+            qWarning() << "替身服务器重新启动失败:" << fast.errorString();
+            return 2;
+        }
+        bool completed = true;
+        for (int i = 0; i < rounds && selector.current() != fast.baseUrl(); ++i) {
+            completed = runProbe(selector) && completed;
+        }
+        bool served = sendRequest(networkManager, selector);
+        bool passed = completed && served
+                      && selector.current() == fast.baseUrl()
+                      && switches == QStringList{fast.baseUrl()};
+        report("recovery", passed, QJsonObject{
+            {"current", selector.current()},
+            {"switches", QJsonArray::fromStringList(switches)},
+            {"servedAfterRecovery", served}
+        });
+    }
+
+    QJsonObject result{
+        {"tool", "serverfailover"},
+        {"rounds", rounds},
+        {"delaysMs", QJsonObject{{"fast", FastDelayMs}, {"medium", MediumDelayMs}, {"slow", SlowDelayMs}}},
+        {"requests", fast.requestCount() + medium.requestCount() + slow.requestCount()},
+        {"cases", cases},
+        {"passed", allPassed}
+    };
+    QTextStream(stdout) << QJsonDocument(result).toJson();
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+#include "standinserver.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPointer>
+#include <QTimer>
+
+StandInResponse StandInResponse::json(const QJsonObject& object, int status)
+{
+    StandInResponse response;
+    response.status = status;
+    response.body = QJsonDocument(object).toJson(QJsonDocument::Compact);
+    return response;
+}
+
+StandInServer::StandInServer(QObject *parent)
+    : QTcpServer(parent)
+{
+    connect(this, &QTcpServer::newConnection, this, &StandInServer::onNewConnection);
+}
+
+bool StandInServer::start(quint16 port)
+{
+    // 重新启动时沿用原来的端口，客户端中保存的地址仍然有效
+    if (!listen(QHostAddress::LocalHost, port ? port : m_port)) {
+        return false;
+    }
+    m_port = serverPort();
+    return true;
+}
+
+void StandInServer::stop()
+{
+    close();
+    const QList<QTcpSocket*> sockets = m_buffers.keys();
+    for (QTcpSocket *socket : sockets) {
+        socket->abort();
+    }
+}
+
+QString StandInServer::baseUrl() const
+{
+    return QString("http://127.0.0.1:%1/api").arg(m_port);
+}
+
+void StandInServer::onNewConnection()
+{
+    while (QTcpSocket *socket = nextPendingConnection()) {
+        m_buffers.insert(socket, QByteArray());
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_buffers.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void StandInServer::onReadyRead(QTcpSocket *socket)
+{
+    QByteArray& buffer = m_buffers[socket];
+    buffer.append(socket->readAll());
+
+    // 同一个连接上可能连续收到多个请求
+    for (;;) {
+        int headerEnd = buffer.indexOf("\r\n\r\n");
+        if (headerEnd < 0) {
+            return;
+        }
+        const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+        const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+        if (requestLine.size() < 2) {
+            socket->abort();
+            return;
+        }
+
+        StandInRequest request;
+        request.method = requestLine[0];
+        QUrl url(QString::fromLatin1(requestLine[1]));
+        request.path = url.path();
+        request.query = QUrlQuery(url);
+        for (int i = 1; i < lines.size(); ++i) {
+            int colon = lines[i].indexOf(':');
+            if (colon > 0) {
+                request.headers.insert(lines[i].left(colon).trimmed().toLower(), lines[i].mid(colon + 1).trimmed());
+            }
+        }
+        int contentLength = request.headers.value("content-length").toInt();
+        if (buffer.size() < headerEnd + 4 + contentLength) {
+            return;
+        }
+        request.body = buffer.mid(headerEnd + 4, contentLength);
+        buffer.remove(0, headerEnd + 4 + contentLength);
+        ++m_requestCount;
+
+        StandInResponse response = m_handler ? m_handler(request) : StandInResponse{404};
+        if (response.dropConnection) {
+            // disconnected信号中清理连接
+            socket->abort();
+            return;
+        }
+        if (response.delayMs > 0) {
+            QPointer<QTcpSocket> guard(socket);
+            QTimer::singleShot(response.delayMs, this, [this, guard, response]() {
+                if (guard) {
+                    respond(guard, response);
+                }
+            });
+        } else {
+            respond(socket, response);
+        }
+    }
+}
+
+void StandInServer::respond(QTcpSocket *socket, const StandInResponse& response)
+{
+    QByteArray head = "HTTP/1.1 " + QByteArray::number(response.status) + " StandIn\r\n";
+    head += "Content-Type: " + response.contentType + "\r\n";
+    head += "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n";
+    head += "Connection: keep-alive\r\n\r\n";
+    socket->write(head + response.body);
+}
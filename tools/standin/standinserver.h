@@ -0,0 +1,65 @@
+#ifndef STANDINSERVER_H
+#define STANDINSERVER_H
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHash>
+#include <QUrlQuery>
+#include <functional>
+
+// 收到的请求
+struct StandInRequest
+{
+    QByteArray method;
+    QString path;                           // 不含查询参数
+    QUrlQuery query;
+    QHash<QByteArray, QByteArray> headers;  // 键为小写
+    QByteArray body;
+};
+
+// 要返回的响应
+struct StandInResponse
+{
+    int status = 200;
+    QByteArray body;
+    QByteArray contentType = "application/json";
+    int delayMs = 0;                // 延迟返回，模拟慢速服务器
+    bool dropConnection = false;    // 不返回响应直接断开连接
+
+    static StandInResponse json(const QJsonObject& object, int status = 200);
+};
+
+// 本地替身服务器
+// 在127.0.0.1的随机端口上提供最简单的HTTP/1.1服务（Content-Length请求体、keep-alive），
+// 每个请求交给handler生成响应，用于在没有SurveyKing服务器的环境中验证客户端的网络逻辑。
+class StandInServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    using Handler = std::function<StandInResponse(const StandInRequest&)>;
+
+    explicit StandInServer(QObject *parent = nullptr);
+
+    void setHandler(const Handler& handler) { m_handler = handler; }
+    // 开始监听，port为0时使用随机端口
+    bool start(quint16 port = 0);
+    // 停止监听并断开所有连接，之后的请求会被拒绝连接
+    void stop();
+
+    // 如 http://127.0.0.1:12345/api
+    QString baseUrl() const;
+    int requestCount() const { return m_requestCount; }
+
+private:
+    void onNewConnection();
+    void onReadyRead(QTcpSocket *socket);
+    void respond(QTcpSocket *socket, const StandInResponse& response);
+
+    Handler m_handler;
+    quint16 m_port = 0;
+    int m_requestCount = 0;
+    QHash<QTcpSocket*, QByteArray> m_buffers;
+};
+
+#endif // STANDINSERVER_H
@@ -0,0 +1,432 @@
+// 问卷表单性能测试
+// 生成SurveyKing格式的问卷，在offscreen平台上驱动SurveyFormWidget，
+// 测量问卷加载、页面渲染、上一题/下一题和答案收集的耗时、提交请求体的大小和编码耗时以及内存峰值，
+// 以及翻页时每题新建题目控件与控件池复用控件的对比，结果以JSON输出。
+//
+// 用法: surveybench --questions 500 --types Radio:3,Checkbox:2,FillBlank:2 --jump-density 0.2 \
+//                   --global-rules 10 --iterations 3 --output result.json
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QTextStream>
+#include <QStackedWidget>
+#include <QVBoxLayout>
+#include <QDebug>
+#include <algorithm>
+#include "surveyformwidget.h"
+#include "settingsmanager.h"
+#include "schemagenerator.h"
+#include "requestbody.h"
+#include "questionpagehost.h"
+
+// 一组耗时样本（毫秒）
+class Samples
+{
+public:
+    void add(double ms) { m_values.append(ms); }
+
+    double mean() const
+    {
+        double total = 0;
+        for (double value : m_values) {
+            total += value;
+        }
+        return m_values.isEmpty() ? 0 : total / m_values.size();
+    }
+
+    QJsonObject toJson() const
+    {
+        if (m_values.isEmpty()) {
+            return QJsonObject{{"count", 0}};
+        }
+        QVector<double> sorted = m_values;
+        std::sort(sorted.begin(), sorted.end());
+        double total = 0;
+        for (double value : sorted) {
+            total += value;
+        }
+        auto percentile = [&sorted](double p) {
+            int index = qBound(0, int(p * (sorted.size() - 1) + 0.5), int(sorted.size()) - 1);
+            return sorted[index];
+        };
+        return QJsonObject{
+            {"count", int(sorted.size())},
+            {"meanMs", total / sorted.size()},
+            {"p50Ms", percentile(0.5)},
+            {"p95Ms", percentile(0.95)},
+            {"maxMs", sorted.last()}
+        };
+    }
+
+private:
+    QVector<double> m_values;
+};
+
+// 通过友元访问表单内部的翻页和收集答案流程，测量的是与用户点击相同的代码路径
+class SurveyFormBenchmark
+{
+public:
+    static int currentIndex(const SurveyFormWidget& form) { return form.m_currentQuestionIndex; }
+    static void next(SurveyFormWidget& form) { form.onNextClicked(); }
+    static void prev(SurveyFormWidget& form) { form.onPrevClicked(); }
+    static void render(SurveyFormWidget& form, int questionIndex) { form.renderQuestionPage(questionIndex); }
+    static QJsonObject collectAnswers(SurveyFormWidget& form) { return form.collectAnswers(); }
+    static int createdViews(const SurveyFormWidget& form) { return form.m_viewPool->createdCount(); }
+    static SurveyEngine *engine(SurveyFormWidget& form) { return form.m_engine; }
+
+    // 按第一个选项作答当前题，答案经题目控件写入答案存储
+    static void answerCurrent(SurveyFormWidget& form)
+    {
+        int index = form.m_currentQuestionIndex;
+        QuestionView *view = form.m_pageHost->view(index);
+        if (!view) {
+            return;
+        }
+        const SurveyQuestion& question = form.m_model->visibleQuestion(index);
+        if (question.options.isEmpty()) {
+            return;
+        }
+
+        QJsonObject answer;
+        switch (question.type) {
+        case QuestionType::Radio:
+        case QuestionType::Checkbox:
+            answer[question.options.first().id] = question.options.first().title;
+            break;
+        case QuestionType::Select:
+            answer[question.options.first().id] = question.options.first().id;
+            break;
+        case QuestionType::FillBlank:
+        case QuestionType::Textarea:
+            answer[question.options.last().id] = "bench";
+            break;
+        case QuestionType::MultipleBlank:
+            for (const SurveyOption& option : question.options) {
+                answer[option.id] = "bench";
+            }
+            break;
+        default:
+            return;
+        }
+        view->setAnswer(answer);
+        form.onAnswerEdited(index);
+    }
+};
+
+// 处理事件一段时间，模拟用户阅读题目，空闲时的预取在这期间执行
+static void idle(int ms)
+{
+    QEventLoop loop;
+    QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+static double elapsedMs(const QElapsedTimer& timer)
+{
+    return timer.nsecsElapsed() / 1000000.0;
+}
+
+// 翻页耗时对比，两种方式都在独立的StackedWidget中逐题切换页面并完成布局:
+//   freshViews   每题用新的控件池新建页面和题目控件，切换后删除上一页
+//   pooledViews  QuestionPageHost的固定槽位加控件池，只保留当前页和上一页（表单现在的做法）
+// 两种方式使用相同的题目控件类，只衡量控件复用带来的差别；控件池之前的页面构造
+// （QGroupBox加逐个控件的内联样式表）代价更高，这里的数字不是改动前后的对比。
+static QJsonObject measurePageSwitch(const SurveyModelPtr& model, int rounds)
+{
+    QStackedWidget stackedWidget;
+    stackedWidget.resize(480, 800);
+    stackedWidget.show();
+
+    Samples freshSamples;
+    int freshViews = 0;
+    for (int round = 0; round < rounds; ++round) {
+        QWidget *previousPage = nullptr;
+        for (int i = 0; i < model->visibleCount(); ++i) {
+            QElapsedTimer timer;
+            timer.start();
+            // 每页使用新的控件池，acquire总是新建控件
+            QuestionViewPool pool;
+            QWidget *page = new QWidget;
+            QVBoxLayout *pageLayout = new QVBoxLayout(page);
+            pageLayout->setContentsMargins(0, 0, 0, 0);
+            pageLayout->addWidget(pool.acquire(model->visibleQuestion(i)));
+            pageLayout->addStretch();
+            stackedWidget.addWidget(page);
+            stackedWidget.setCurrentWidget(page);
+            page->adjustSize();
+            pageLayout->activate();
+            delete previousPage;
+            previousPage = page;
+            freshSamples.add(elapsedMs(timer));
+            freshViews += pool.createdCount();
+        }
+        delete previousPage;
+        idle(0);
+    }
+
+    Samples pooledSamples;
+    QuestionViewPool pool;
+    QuestionPageHost pageHost(&stackedWidget, &pool);
+    for (int round = 0; round < rounds; ++round) {
+        pageHost.reset(model);
+        for (int i = 0; i < model->visibleCount(); ++i) {
+            QElapsedTimer timer;
+            timer.start();
+            pageHost.materialize(i);
+            pageHost.show(i);
+            pageHost.retain({i - 1, i});
+            QWidget *page = pageHost.page(i);
+            page->adjustSize();
+            if (page->layout()) {
+                page->layout()->activate();
+            }
+            pooledSamples.add(elapsedMs(timer));
+        }
+        idle(0);
+    }
+
+    double pooledMean = pooledSamples.mean();
+    return QJsonObject{
+        {"rounds", rounds},
+        {"freshViews", freshSamples.toJson()},
+        {"freshCreatedViews", freshViews},
+        {"pooledViews", pooledSamples.toJson()},
+        {"pooledCreatedViews", pool.createdCount()},
+        {"pooledSpeedup", pooledMean > 0 ? freshSamples.mean() / pooledMean : 0.0}
+    };
+}
+
+// saveAnswer请求体在各种编码方式下的大小和编码耗时
+static QJsonObject measurePayload(const QJsonObject& answers)
+{
+    QJsonObject body{
+        {"projectId", "bench"},
+        {"answer", answers},
+        {"tempSave", 1},
+        {"metaInfo", QJsonObject{
+            {"clientInfo", QJsonObject{{"agent", "Mobile Client"}, {"remoteIp", "192.168.1.100"}}},
+            {"answerInfo", QJsonObject{{"startTime", "1700000000000"}, {"endTime", "1700000600000"}}}
+        }}
+    };
+
+    struct Variant {
+        const char *name;
+        BodyEncoding encoding;
+        bool indented;
+    };
+    const Variant variants[] = {
+        {"indented", BodyEncoding::Identity, true},
+        {"compact", BodyEncoding::Identity, false},
+        {"deflate", BodyEncoding::Deflate, false},
+        {"gzip", BodyEncoding::Gzip, false}
+    };
+
+    QJsonObject result;
+    for (const Variant& variant : variants) {
+        Samples encodeSamples;
+        qint64 bytes = 0;
+        for (int i = 0; i < 20; ++i) {
+            QElapsedTimer timer;
+            timer.start();
+            QByteArray data = variant.indented ? QJsonDocument(body).toJson()
+                                               : encodeRequestBody(body, variant.encoding, nullptr, 0);
+            encodeSamples.add(elapsedMs(timer));
+            bytes = data.size();
+        }
+        result[variant.name] = QJsonObject{{"bytes", bytes}, {"encode", encodeSamples.toJson()}};
+    }
+    return result;
+}
+
+// 进程内存峰值(KB)，不支持的平台返回-1
+static qint64 peakMemoryKb()
+{
+#ifdef Q_OS_LINUX
+    QFile status("/proc/self/status");
+    if (status.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> lines = status.readAll().split('\n');
+        for (const QByteArray& line : lines) {
+            if (line.startsWith("VmHWM:")) {
+                return line.mid(6).trimmed().split(' ').first().toLongLong();
+            }
+        }
+    }
+#endif
+    return -1;
+}
+
+int main(int argc, char *argv[])
+{
+    // 默认在offscreen平台运行，不需要显示器
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("问卷表单性能测试");
+    parser.addHelpOption();
+    QCommandLineOption questionsOption("questions", "题目数量", "n", "100");
+    QCommandLineOption optionsOption("options", "选择题选项数量", "n", "5");
+    QCommandLineOption typesOption("types", "题型及权重，如 Radio:3,Checkbox:2", "list");
+    QCommandLineOption jumpOption("jump-density", "单选/下拉题带跳转规则的比例", "ratio", "0.1");
+    QCommandLineOption globalOption("global-rules", "全局规则数量", "n", "0");
+    QCommandLineOption seedOption("seed", "随机种子", "n", "1");
+    QCommandLineOption iterationsOption("iterations", "重复次数", "n", "1");
+    QCommandLineOption thinkOption("think-ms", "每题作答后的空闲时间(ms)", "ms", "60");
+    QCommandLineOption outputOption("output", "结果文件，默认输出到标准输出", "file");
+    parser.addOptions({questionsOption, optionsOption, typesOption, jumpOption, globalOption,
+                       seedOption, iterationsOption, thinkOption, outputOption});
+    parser.process(app);
+
+    SchemaGeneratorOptions generatorOptions;
+    generatorOptions.questions = parser.value(questionsOption).toInt();
+    generatorOptions.options = parser.value(optionsOption).toInt();
+    generatorOptions.jumpDensity = parser.value(jumpOption).toDouble();
+    generatorOptions.globalRules = parser.value(globalOption).toInt();
+    generatorOptions.seed = parser.value(seedOption).toUInt();
+    if (parser.isSet(typesOption) && !generatorOptions.parseTypeWeights(parser.value(typesOption))) {
+        qWarning() << "题型参数格式错误:" << parser.value(typesOption);
+        return 2;
+    }
+    const int iterations = qMax(1, parser.value(iterationsOption).toInt());
+    const int thinkMs = qMax(0, parser.value(thinkOption).toInt());
+
+    // 性能测试不启用录音和拍照
+    SettingsManager::getInstance().setValue("survey/autoRecord", false);
+    SettingsManager::getInstance().setValue("survey/autoCapture", false);
+
+    QJsonObject schema = generateSurveySchema(generatorOptions);
+
+    SurveyFormWidget form;
+    form.resize(480, 800);
+    form.show();
+
+    Samples buildSamples;
+    Samples loadSamples;
+    Samples renderSamples;
+    Samples answerSamples;
+    Samples nextSamples;
+    Samples prevSamples;
+    Samples collectSamples;
+    int visitedPages = 0;
+    qint64 memoryBeforeKb = peakMemoryKb();
+
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        QElapsedTimer timer;
+
+        // 问卷模型在客户端中由网络线程编译，这里单独计时
+        timer.start();
+        SurveyModelPtr model = SurveyModel::build(schema);
+        buildSamples.add(elapsedMs(timer));
+
+        timer.start();
+        form.setSurveyModel(model);
+        loadSamples.add(elapsedMs(timer));
+        idle(thinkMs);
+
+        // 按第一个选项作答并一直点击下一题，直到最后一题
+        int lastIndex = -1;
+        while (SurveyFormBenchmark::currentIndex(form) != lastIndex) {
+            lastIndex = SurveyFormBenchmark::currentIndex(form);
+            ++visitedPages;
+
+            timer.start();
+            SurveyFormBenchmark::answerCurrent(form);
+            answerSamples.add(elapsedMs(timer));
+            idle(thinkMs);
+
+            timer.start();
+            SurveyFormBenchmark::next(form);
+            if (SurveyFormBenchmark::currentIndex(form) != lastIndex) {
+                nextSamples.add(elapsedMs(timer));
+            }
+        }
+
+        // 答案收集
+        for (int i = 0; i < 20; ++i) {
+            timer.start();
+            QJsonObject answers = SurveyFormBenchmark::collectAnswers(form);
+            collectSamples.add(elapsedMs(timer));
+            Q_UNUSED(answers)
+        }
+
+        // 一直点击上一题回到第一题
+        while (SurveyFormBenchmark::currentIndex(form) > 0) {
+            timer.start();
+            SurveyFormBenchmark::prev(form);
+            prevSamples.add(elapsedMs(timer));
+            idle(0);
+        }
+
+        // 逐页渲染所有题目，相邻页面之外都需要重新绑定
+        for (int i = 0; i < model->visibleCount(); ++i) {
+            timer.start();
+            SurveyFormBenchmark::render(form, i);
+            renderSamples.add(elapsedMs(timer));
+        }
+        idle(0);
+    }
+
+    // 翻页方式对比，与上面的表单流程分开，不受预取和答案恢复影响
+    QJsonObject pageSwitch = measurePageSwitch(SurveyModel::build(schema), iterations);
+
+    // 提交请求体：附带选项文字与只写选项id两种答案格式
+    SurveyEngine *engine = SurveyFormBenchmark::engine(form);
+    bool compactChoices = engine->compactChoiceAnswers();
+    engine->setCompactChoiceAnswers(false);
+    QJsonObject labelPayload = measurePayload(engine->submitPayload());
+    engine->setCompactChoiceAnswers(true);
+    QJsonObject optionIdPayload = measurePayload(engine->submitPayload());
+    engine->setCompactChoiceAnswers(compactChoices);
+
+    QJsonObject parameters{
+        {"questions", generatorOptions.questions},
+        {"options", generatorOptions.options},
+        {"types", parser.value(typesOption)},
+        {"jumpDensity", generatorOptions.jumpDensity},
+        {"globalRules", generatorOptions.globalRules},
+        {"seed", qint64(generatorOptions.seed)},
+        {"iterations", iterations},
+        {"thinkMs", thinkMs}
+    };
+    QJsonObject result{
+        {"tool", "surveybench"},
+        {"qtVersion", QString(qVersion())},
+        {"platform", QApplication::platformName()},
+        {"parameters", parameters},
+        {"schemaBuild", buildSamples.toJson()},
+        {"setSurveyModel", loadSamples.toJson()},
+        {"renderQuestionPage", renderSamples.toJson()},
+        {"answer", answerSamples.toJson()},
+        {"next", nextSamples.toJson()},
+        {"prev", prevSamples.toJson()},
+        {"collectAnswers", collectSamples.toJson()},
+        {"pageSwitch", pageSwitch},
+        {"payload", QJsonObject{{"optionLabels", labelPayload}, {"optionIds", optionIdPayload}}},
+        {"visitedPages", visitedPages},
+        {"createdViews", SurveyFormBenchmark::createdViews(form)},
+        {"peakMemoryKbBefore", memoryBeforeKb},
+        {"peakMemoryKb", peakMemoryKb()}
+    };
+
+    QByteArray json = QJsonDocument(result).toJson();
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning() << "无法写入文件:" << parser.value(outputOption);
+            return 2;
+        }
+        file.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "schemagenerator.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <QStringList>
+
+bool SchemaGeneratorOptions::parseTypeWeights(const QString& text)
+{
+    QList<QPair<QString, int>> weights;
+    const QStringList items = text.split(',', Qt::SkipEmptyParts);
+    for (const QString& item : items) {
+        QStringList parts = item.split(':');
+        bool ok = true;
+        int weight = parts.size() > 1 ? parts[1].toInt(&ok) : 1;
+        if (parts[0].trimmed().isEmpty() || !ok || weight <= 0) {
+            return false;
+        }
+        weights.append(qMakePair(parts[0].trimmed(), weight));
+    }
+    if (weights.isEmpty()) {
+        return false;
+    }
+    typeWeights = weights;
+    return true;
+}
+
+static QString pickType(const SchemaGeneratorOptions& options, QRandomGenerator& random)
+{
+    int total = 0;
+    for (const auto& weight : options.typeWeights) {
+        total += weight.second;
+    }
+    int value = random.bounded(total);
+    for (const auto& weight : options.typeWeights) {
+        if (value < weight.second) {
+            return weight.first;
+        }
+        value -= weight.second;
+    }
+    return options.typeWeights.last().first;
+}
+
+static QJsonObject makeOption(const QString& id, const QString& title)
+{
+    return QJsonObject{
+        {"id", id},
+        {"title", title},
+        {"attribute", QJsonObject{{"dataType", ""}}},
+        {"children", QJsonArray()}
+    };
+}
+
+QJsonObject generateSurveySchema(const SchemaGeneratorOptions& options)
+{
+    SchemaGeneratorOptions effective = options;
+    if (effective.typeWeights.isEmpty()) {
+        effective.parseTypeWeights("Radio:3,Checkbox:2,FillBlank:2,Select:1,MultipleBlank:1,Textarea:1,Score:1");
+    }
+
+    QRandomGenerator random(effective.seed);
+    const int questionCount = qMax(1, effective.questions);
+    const int optionCount = qMax(1, effective.options);
+
+    QJsonArray questions;
+    QStringList choiceQuestions; // 可用于全局规则条件的选择题
+    for (int i = 0; i < questionCount; ++i) {
+        QString questionId = QString("q%1").arg(i);
+        QString type = pickType(effective, random);
+
+        // 文本题只有一个答案子字段，选择题和多项填空题按参数生成选项
+        bool multiOption = type == "Radio" || type == "Checkbox" || type == "Select" || type == "MultipleBlank";
+        int count = multiOption ? optionCount : 1;
+        QJsonArray children;
+        for (int j = 0; j < count; ++j) {
+            children.append(makeOption(QString("%1o%2").arg(questionId).arg(j), QString("选项%1").arg(j)));
+        }
+
+        QJsonObject attribute{{"required", random.generateDouble() < effective.requiredRatio}};
+
+        // 跳转规则：选中第一个选项时向后跳过几道题
+        bool canJump = (type == "Radio" || type == "Select") && i + 2 < questionCount;
+        if (canJump && random.generateDouble() < effective.jumpDensity) {
+            int target = qMin(questionCount - 1, i + 2 + random.bounded(4));
+            attribute["jumpRule"] = QString("#{%1} == #{%1.%1o0} && jump('q%2')").arg(questionId).arg(target);
+        }
+        if ((type == "Radio" || type == "Checkbox") && optionCount > 1) {
+            choiceQuestions.append(questionId);
+        }
+
+        questions.append(QJsonObject{
+            {"id", questionId},
+            {"title", QString("第%1题 %2").arg(i + 1).arg(type)},
+            {"description", ""},
+            {"type", type},
+            {"attribute", attribute},
+            {"children", children}
+        });
+    }
+
+    QJsonArray globalRules;
+    for (int i = 0; i < effective.globalRules; ++i) {
+        QString questionId = QString("q%1").arg(random.bounded(questionCount));
+        if (i % 2 == 0 && !choiceQuestions.isEmpty()) {
+            // 结构化规则：条件为选中最后一个选项，按第一个选项作答时不会触发跳转
+            QString conditionQuestion = choiceQuestions[random.bounded(int(choiceQuestions.size()))];
+            QJsonObject rule{
+                {"conditionItem", QJsonArray{QJsonObject{
+                    {"qId", conditionQuestion},
+                    {"condition", "CHECKED"},
+                    {"oId", QJsonArray{QString("%1o%2").arg(conditionQuestion).arg(optionCount - 1)}}
+                }}},
+                {"conditionLogic", "AND"},
+                {"result", QJsonArray{QJsonObject{{"type", "jump"}, {"qId", questionId}}}}
+            };
+            globalRules.append(QString::fromUtf8(QJsonDocument(rule).toJson(QJsonDocument::Compact)));
+        } else {
+            // 表达式规则：结果恒为true，但引用了题目答案，会进入依赖索引
+            globalRules.append(QString("true || #{%1} == 'never'").arg(questionId));
+        }
+    }
+
+    return QJsonObject{
+        {"id", QString("bench-%1-%2").arg(questionCount).arg(effective.seed)},
+        {"name", "性能测试问卷"},
+        {"survey", QJsonObject{
+            {"title", QString("性能测试问卷（%1题）").arg(questionCount)},
+            {"description", "由surveybench生成"},
+            {"children", questions},
+            {"attribute", QJsonObject{{"globalRule", globalRules}}}
+        }}
+    };
+}
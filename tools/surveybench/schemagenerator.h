@@ -0,0 +1,29 @@
+#ifndef SCHEMAGENERATOR_H
+#define SCHEMAGENERATOR_H
+
+#include <QString>
+#include <QList>
+#include <QPair>
+#include <QJsonObject>
+
+// 生成SurveyKing格式问卷的参数
+struct SchemaGeneratorOptions
+{
+    int questions = 100;            // 可见题目数量
+    int options = 5;                // 选择题的选项数量，多项填空题的填空数量
+    // 题型及权重，如 Radio:3,Checkbox:2,FillBlank:2
+    QList<QPair<QString, int>> typeWeights;
+    double jumpDensity = 0.1;       // 单选/下拉题带跳转规则的比例
+    int globalRules = 0;            // 全局规则数量，结构化规则和表达式规则各一半
+    double requiredRatio = 0.0;     // 必填题比例
+    quint32 seed = 1;
+
+    // 解析 "Radio:3,Checkbox:2" 形式的题型权重，格式错误返回false
+    bool parseTypeWeights(const QString& text);
+};
+
+// 按参数生成问卷，格式与loadProject接口的data字段一致，同样的参数生成同样的问卷
+// 跳转规则只向后跳转，全局规则都不会阻止翻页，按第一个选项作答可以从第一题走到最后一题
+QJsonObject generateSurveySchema(const SchemaGeneratorOptions& options);
+
+#endif // SCHEMAGENERATOR_H
@@ -0,0 +1,185 @@
+// 问卷会话回放工具
+// 把录制的作答事件逐条交给SurveyEngine，对比翻页决策和提交数据，并统计吞吐量。
+//
+// 用法: surveyreplay <问卷schema.json> <会话.json> [--repeat N] [--record 输出.json]
+//
+// 会话文件格式:
+// {"sessions": [{
+//     "id": "s1",
+//     "events": [{"answer": "题目id", "value": {"选项id": "取值"}},
+//                {"action": "next"}, {"action": "prev"}, {"action": "submit"}],
+//     "decisions": [{"action": "goto", "target": 1}, ...],   // 可选，期望的决策
+//     "payload": {...}                                         // 可选，期望的提交数据
+// }]}
+// --record 把本次回放得到的决策和提交数据写回会话文件格式，作为之后回归对比的基线。
+//
+// fixtures/ 中是覆盖跳转规则和全局跳转规则的回归用例:
+//   surveyreplay fixtures/rules_schema.json fixtures/rules_sessions.json
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QDebug>
+#include "surveyengine.h"
+
+static bool readJson(const QString& path, QJsonObject *object)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "无法打开文件:" << path;
+        return false;
+    }
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+        qWarning() << "JSON解析失败:" << path << error.errorString();
+        return false;
+    }
+    *object = doc.object();
+    return true;
+}
+
+// 回放一个会话，返回产生的决策，提交时的答案写入payload
+static QJsonArray replaySession(SurveyEngine& engine, const SurveyModelPtr& model,
+                                const QJsonArray& events, QJsonObject *payload)
+{
+    QJsonArray decisions;
+    engine.setModel(model);
+
+    for (const QJsonValue& value : events) {
+        QJsonObject event = value.toObject();
+        if (event.contains("answer")) {
+            engine.setAnswer(event["answer"].toString(), event["value"].toObject());
+            continue;
+        }
+
+        QString action = event["action"].toString();
+        SurveyNavigation navigation;
+        if (action == "next") {
+            navigation = engine.next();
+        } else if (action == "prev") {
+            navigation = engine.previous();
+        } else if (action == "submit") {
+            navigation = engine.submit();
+        } else {
+            qWarning() << "忽略未知事件:" << event;
+            continue;
+        }
+
+        QJsonObject decision{{"action", SurveyNavigation::actionName(navigation.action)}};
+        if (navigation.action == SurveyNavigation::Goto) {
+            decision["target"] = navigation.targetIndex;
+        }
+        decisions.append(decision);
+
+        if (navigation.action == SurveyNavigation::Submit) {
+            *payload = engine.submitPayload();
+            break;
+        }
+    }
+    return decisions;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    QTextStream out(stdout);
+
+    if (args.size() < 3) {
+        out << "用法: surveyreplay <问卷schema.json> <会话.json> [--repeat N] [--record 输出.json]\n";
+        return 2;
+    }
+
+    int repeat = 1;
+    QString recordPath;
+    for (int i = 3; i < args.size(); ++i) {
+        if (args[i] == "--repeat" && i + 1 < args.size()) {
+            repeat = qMax(1, args[++i].toInt());
+        } else if (args[i] == "--record" && i + 1 < args.size()) {
+            recordPath = args[++i];
+        }
+    }
+
+    QJsonObject schema;
+    QJsonObject sessionFile;
+    if (!readJson(args[1], &schema) || !readJson(args[2], &sessionFile)) {
+        return 2;
+    }
+    // 兼容直接保存的loadProject接口响应
+    if (schema["data"].isObject()) {
+        schema = schema["data"].toObject();
+    }
+
+    QElapsedTimer buildTimer;
+    buildTimer.start();
+    SurveyModelPtr model = SurveyModel::build(schema);
+    double buildMs = buildTimer.nsecsElapsed() / 1000000.0;
+
+    SurveyEngine engine;
+    QJsonArray sessions = sessionFile["sessions"].toArray();
+    QJsonArray recorded;
+    int mismatches = 0;
+    qint64 eventCount = 0;
+
+    QElapsedTimer replayTimer;
+    replayTimer.start();
+    for (int round = 0; round < repeat; ++round) {
+        for (int i = 0; i < sessions.size(); ++i) {
+            QJsonObject session = sessions[i].toObject();
+            QJsonArray events = session["events"].toArray();
+            QJsonObject payload;
+            QJsonArray decisions = replaySession(engine, model, events, &payload);
+            eventCount += events.size();
+
+            // 只在第一轮对比和记录，后续轮次只用于测量吞吐量
+            if (round > 0) {
+                continue;
+            }
+            bool decisionsMatch = !session.contains("decisions") || session["decisions"].toArray() == decisions;
+            bool payloadMatch = !session.contains("payload") || session["payload"].toObject() == payload;
+            if (!decisionsMatch || !payloadMatch) {
+                ++mismatches;
+                qWarning() << "会话结果与记录不一致:" << session["id"].toString()
+                           << "决策:" << decisionsMatch << "提交数据:" << payloadMatch;
+            }
+            if (!recordPath.isEmpty()) {
+                session["decisions"] = decisions;
+                session["payload"] = payload;
+                recorded.append(session);
+            }
+        }
+    }
+    double replayMs = replayTimer.nsecsElapsed() / 1000000.0;
+
+    if (!recordPath.isEmpty()) {
+        QFile file(recordPath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning() << "无法写入文件:" << recordPath;
+            return 2;
+        }
+        file.write(QJsonDocument(QJsonObject{{"sessions", recorded}}).toJson());
+    }
+
+    // 结果以JSON输出，便于脚本对比不同版本
+    qint64 sessionCount = qint64(sessions.size()) * repeat;
+    double seconds = replayMs / 1000.0;
+    QJsonObject result{
+        {"questions", model->visibleCount()},
+        {"globalRules", int(model->globalRules().size())},
+        {"schemaBuildMs", buildMs},
+        {"sessions", sessionCount},
+        {"events", eventCount},
+        {"replayMs", replayMs},
+        {"sessionsPerSecond", seconds > 0 ? sessionCount / seconds : 0.0},
+        {"eventsPerSecond", seconds > 0 ? eventCount / seconds : 0.0},
+        {"mismatches", mismatches}
+    };
+    out << QJsonDocument(result).toJson();
+
+    return mismatches == 0 ? 0 : 1;
+}
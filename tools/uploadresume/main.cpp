@@ -0,0 +1,290 @@
+// 分片断点续传验证工具
+// 用本地替身服务器提供 /public/upload/chunk/init|chunk|complete，检查ChunkedUploader:
+//   resume          上传到一半断开连接，重新创建上传器（模拟重启）后再次上传同一个文件，只发送缺失的分片
+//   init-rejected   初始化请求返回403或200加错误响应时通知改用整文件上传
+//   bogus-received  服务器返回越界的分片下标时进度不为负数，也不会跳过分片
+// 结果以JSON输出，全部通过时返回0。
+//
+// 用法: uploadresume [--chunks 8] [--drop-at 3]
+
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QTimer>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QCryptographicHash>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QDebug>
+#include <QMap>
+#include <QSet>
+#include "chunkeduploader.h"
+#include "standinserver.h"
+
+static const qint64 ChunkSize = 64 * 1024;
+
+// 替身服务器上的分片上传状态
+class ChunkStandIn
+{
+public:
+    int dropFrom = -1;              // 从这个分片开始断开连接，-1表示不断开
+    int initStatus = 200;           // 初始化请求的状态码
+    bool initErrorBody = false;     // 初始化返回200加错误响应
+    QJsonArray extraReceived;       // 初始化时额外返回的分片下标
+
+    QString initUploadId;           // 最近一次初始化请求带的uploadId
+    QList<int> sentParts;           // 收到的分片下标，按顺序
+    int completes = 0;
+    QByteArray assembledMd5;
+
+    StandInResponse handle(const StandInRequest& request)
+    {
+        if (request.path == "/api/public/upload/chunk/init") {
+            QJsonObject body = QJsonDocument::fromJson(request.body).object();
+            initUploadId = body["uploadId"].toString();
+            if (initStatus != 200) {
+                return StandInResponse::json(QJsonObject{{"message", "forbidden"}}, initStatus);
+            }
+            if (initErrorBody) {
+                return StandInResponse::json(QJsonObject{{"code", 500}, {"error", true}, {"message", "unknown route"}});
+            }
+            QString uploadId = m_chunks.contains(initUploadId) ? initUploadId : QString("upload-%1").arg(m_chunks.size() + 1);
+            QMap<int, QByteArray>& chunks = m_chunks[uploadId];
+            QJsonArray received = extraReceived;
+            for (auto it = chunks.constBegin(); it != chunks.constEnd(); ++it) {
+                received.append(it.key());
+            }
+            return StandInResponse::json(QJsonObject{
+                {"code", 200},
+                {"data", QJsonObject{{"uploadId", uploadId}, {"received", received}}}
+            });
+        }
+        if (request.path == "/api/public/upload/chunk") {
+            int index = request.query.queryItemValue("index").toInt();
+            sentParts.append(index);
+            if (dropFrom >= 0 && index >= dropFrom) {
+                StandInResponse response;
+                response.dropConnection = true;
+                return response;
+            }
+            QByteArray md5 = QCryptographicHash::hash(request.body, QCryptographicHash::Md5).toBase64();
+            if (md5 != request.headers.value("content-md5")) {
+                return StandInResponse::json(QJsonObject{{"message", "md5 mismatch"}}, 400);
+            }
+            m_chunks[request.query.queryItemValue("uploadId")].insert(index, request.body);
+            return StandInResponse::json(QJsonObject{{"code", 200}});
+        }
+        if (request.path == "/api/public/upload/chunk/complete") {
+            ++completes;
+            QString uploadId = QJsonDocument::fromJson(request.body).object()["uploadId"].toString();
+            QByteArray data;
+            for (const QByteArray& chunk : std::as_const(m_chunks[uploadId])) {
+                data += chunk;
+            }
+            assembledMd5 = QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex();
+            return StandInResponse::json(QJsonObject{{"code", 200}, {"data", QJsonObject{{"id", "file-" + uploadId}}}});
+        }
+        return StandInResponse::json(QJsonObject{{"message", "not found"}}, 404);
+    }
+
+private:
+    QHash<QString, QMap<int, QByteArray>> m_chunks;  // uploadId -> 分片下标 -> 内容
+};
+
+// 一次upload()的结果
+struct UploadOutcome
+{
+    bool finished = false;
+    bool failed = false;
+    bool unsupported = false;
+    bool timedOut = false;
+    qint64 minProgress = 0;
+    qint64 maxProgress = 0;
+};
+
+static UploadOutcome runUpload(ChunkedUploader& uploader, const QString& filePath, int timeoutMs = 10000)
+{
+    UploadOutcome outcome;
+    QEventLoop loop;
+    QMetaObject::Connection finished = QObject::connect(&uploader, &ChunkedUploader::finished, &loop,
+                                                        [&](const QVariant&, const QJsonObject&) {
+        outcome.finished = true;
+        loop.quit();
+    });
+    QMetaObject::Connection failed = QObject::connect(&uploader, &ChunkedUploader::failed, &loop,
+                                                      [&](const QVariant&, const QString&, bool unsupported) {
+        outcome.failed = true;
+        outcome.unsupported = unsupported;
+        loop.quit();
+    });
+    QMetaObject::Connection progress = QObject::connect(&uploader, &ChunkedUploader::progress, &loop,
+                                                        [&](const QVariant&, qint64 bytesSent, qint64) {
+        outcome.minProgress = qMin(outcome.minProgress, bytesSent);
+        outcome.maxProgress = qMax(outcome.maxProgress, bytesSent);
+    });
+    QTimer::singleShot(timeoutMs, &loop, [&]() {
+        outcome.timedOut = true;
+        loop.quit();
+    });
+    if (uploader.upload("project", "question", filePath)) {
+        loop.exec();
+    } else {
+        outcome.failed = true;
+    }
+    QObject::disconnect(finished);
+    QObject::disconnect(failed);
+    QObject::disconnect(progress);
+    return outcome;
+}
+
+static QByteArray writeRandomFile(const QString& path, qint64 size)
+{
+    QByteArray data(int(size), Qt::Uninitialized);
+    for (char& byte : data) {
+        byte = char(QRandomGenerator::global()->bounded(256));
+    }
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(data);
+    }
+    return QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    int chunks = 8;
+    int dropAt = 3;
+    const QStringList args = app.arguments();
+    for (int i = 1; i < args.size(); ++i) {
+        if (args[i] == "--chunks" && i + 1 < args.size()) {
+            chunks = qMax(2, args[++i].toInt());
+        } else if (args[i] == "--drop-at" && i + 1 < args.size()) {
+            dropAt = args[++i].toInt();
+        }
+    }
+    dropAt = qBound(1, dropAt, chunks - 1);
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        qWarning() << "无法创建临时目录";
+        return 2;
+    }
+    // 最后一个分片不满，覆盖尾部分片的大小计算
+    QString filePath = dir.filePath("upload.bin");
+    QByteArray fileMd5 = writeRandomFile(filePath, (chunks - 1) * ChunkSize + ChunkSize / 3);
+
+    ChunkStandIn standIn;
+    StandInServer server;
+    server.setHandler([&standIn](const StandInRequest& request) { return standIn.handle(request); });
+    if (!server.start()) {
+        qWarning() << "替身服务器启动失败:" << server.errorString();
+        return 2;
+    }
+
+    QNetworkAccessManager networkManager;
+    QJsonArray cases;
+    bool allPassed = true;
+    auto report = [&](const QString& name, bool passed, const QJsonObject& details) {
+        QJsonObject result = details;
+        result["case"] = name;
+        result["passed"] = passed;
+        cases.append(result);
+        allPassed = allPassed && passed;
+    };
+    auto partsToJson = [](const QList<int>& parts) {
+        QJsonArray array;
+        for (int index : parts) {
+            array.append(index);
+        }
+        return array;
+    };
+
+    // resume: 第一次上传在dropAt处断开，第二次只应发送dropAt之后的分片
+    {
+        QString progressFile = dir.filePath("resume_progress.json");
+        standIn.dropFrom = dropAt;
+        UploadOutcome first;
+        {
+            ChunkedUploader uploader(&networkManager, progressFile);
+            uploader.setBaseUrl(server.baseUrl());
+            uploader.setChunkSize(ChunkSize);
+            first = runUpload(uploader, filePath);
+        }
+        QList<int> firstParts = standIn.sentParts;
+
+        standIn.dropFrom = -1;
+        standIn.sentParts.clear();
+        ChunkedUploader uploader(&networkManager, progressFile);
+        uploader.setBaseUrl(server.baseUrl());
+        uploader.setChunkSize(ChunkSize);
+        UploadOutcome second = runUpload(uploader, filePath);
+
+        QList<int> expected;
+        for (int index = dropAt; index < chunks; ++index) {
+            expected.append(index);
+        }
+        bool passed = first.failed && !first.unsupported
+                      && second.finished && !standIn.initUploadId.isEmpty()
+                      && standIn.sentParts == expected
+                      && standIn.completes == 1 && standIn.assembledMd5 == fileMd5;
+        report("resume", passed, QJsonObject{
+            {"firstFailed", first.failed},
+            {"firstParts", partsToJson(firstParts)},
+            {"resumedUploadId", standIn.initUploadId},
+            {"secondParts", partsToJson(standIn.sentParts)},
+            {"expectedParts", partsToJson(expected)},
+            {"assembledMd5Matches", standIn.assembledMd5 == fileMd5}
+        });
+    }
+
+    // init-rejected: 服务器用403或200加错误响应拒绝未知接口时改用整文件上传
+    for (int variant = 0; variant < 2; ++variant) {
+        standIn.initStatus = variant == 0 ? 403 : 200;
+        standIn.initErrorBody = variant == 1;
+        ChunkedUploader uploader(&networkManager, dir.filePath(QString("rejected_progress_%1.json").arg(variant)));
+        uploader.setBaseUrl(server.baseUrl());
+        uploader.setChunkSize(ChunkSize);
+        UploadOutcome outcome = runUpload(uploader, filePath);
+        report(variant == 0 ? "init-rejected-403" : "init-rejected-error-body", outcome.failed && outcome.unsupported,
+               QJsonObject{{"failed", outcome.failed}, {"unsupported", outcome.unsupported}});
+    }
+    standIn.initStatus = 200;
+    standIn.initErrorBody = false;
+
+    // bogus-received: 越界的分片下标被忽略，所有分片都会发送
+    {
+        standIn.extraReceived = QJsonArray{-5, chunks, chunks + 100};
+        standIn.sentParts.clear();
+        ChunkedUploader uploader(&networkManager, dir.filePath("bogus_progress.json"));
+        uploader.setBaseUrl(server.baseUrl());
+        uploader.setChunkSize(ChunkSize);
+        UploadOutcome outcome = runUpload(uploader, filePath);
+        qint64 fileSize = QFile(filePath).size();
+        bool passed = outcome.finished && outcome.minProgress >= 0 && outcome.maxProgress <= fileSize
+                      && standIn.sentParts.size() == chunks;
+        report("bogus-received", passed, QJsonObject{
+            {"finished", outcome.finished},
+            {"minProgress", outcome.minProgress},
+            {"maxProgress", outcome.maxProgress},
+            {"sentParts", partsToJson(standIn.sentParts)}
+        });
+        standIn.extraReceived = QJsonArray();
+    }
+
+    QJsonObject result{
+        {"tool", "uploadresume"},
+        {"chunks", chunks},
+        {"chunkSize", ChunkSize},
+        {"dropAt", dropAt},
+        {"requests", server.requestCount()},
+        {"cases", cases},
+        {"passed", allPassed}
+    };
+    QTextStream(stdout) << QJsonDocument(result).toJson();
+    return allPassed ? 0 : 1;
+}